@@ -0,0 +1,94 @@
+// Дедупликация больших строк по кускам.
+// Запуск: bench_chunk_dedup [items] [item_kb] > result.json
+// Строки — версии одного случайного документа: каждая получена из предыдущей
+// несколькими вставками, удалениями и заменами по 1-64 байта. whole — DeDuplicate,
+// которому почти все версии кажутся разными; chunks — ChunkDeDuplicate с разными
+// средними размерами кусков. ratio учитывает и списки номеров кусков.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "bench.h"
+#include "chunk_dedup.h"
+#include "dedup.h"
+
+int main(int argc, char** argv) {
+    size_t count = 200;
+    size_t item_size = size_t{256} << 10;
+    if (argc > 1) {
+        count = std::strtoull(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        item_size = std::strtoull(argv[2], nullptr, 10) << 10;
+    }
+
+    std::mt19937_64 gen(20251012);
+    std::string document(item_size, '\0');
+    for (auto& c : document) {
+        c = static_cast<char>('a' + gen() % 26);
+    }
+    std::vector<std::unique_ptr<string>> items;
+    size_t input = 0;
+    for (size_t i = 0; i < count; ++i) {
+        for (int edit = 0; edit < 4; ++edit) {
+            size_t pos = gen() % document.size();
+            size_t len = 1 + gen() % 64;
+            switch (gen() % 3) {
+                case 0:
+                    document.insert(pos, len, static_cast<char>('A' + gen() % 26));
+                    break;
+                case 1:
+                    document.erase(pos, len);
+                    break;
+                default:
+                    for (size_t j = pos; j < std::min(pos + len, document.size()); ++j) {
+                        document[j] = static_cast<char>('A' + gen() % 26);
+                    }
+            }
+        }
+        // каждая четвёртая версия повторяет предыдущую
+        items.push_back(std::make_unique<string>(i % 4 == 3 ? *items.back() : document));
+        input += items.back()->size();
+    }
+
+    bench::Report report("chunk_dedup");
+    auto add = [&](const char* impl, size_t avg, double ratio, double ns) {
+        double mb_per_s = static_cast<double>(input) / ns * 1e3;
+        report.Add().Set("op", "dedup").Set("impl", impl).Set("avg_size", avg).Set(
+            "size", input).Set("ratio", ratio).Set("mb_per_s", mb_per_s);
+        std::fprintf(stderr, "%-6s avg %6zu: ratio %7.2f, %8.1f MB/s\n", impl, avg, ratio,
+                     mb_per_s);
+    };
+
+    {
+        std::vector<std::shared_ptr<string>> shared;
+        double ns = bench::BestNs([&] { shared = DeDuplicate(items); }, 1);
+        std::unordered_set<const string*> unique;
+        size_t stored = 0;
+        for (const auto& item : shared) {
+            if (unique.insert(item.get()).second) {
+                stored += item->size();
+            }
+        }
+        add("whole", 0, static_cast<double>(input) / stored, ns);
+    }
+    for (size_t avg : {size_t{1024}, size_t{4096}, size_t{8192}, size_t{16384}}) {
+        ChunkParams params{avg / 4, avg, avg * 8};
+        double ratio = 0;
+        double ns = bench::BestNs([&] {
+            auto chunked = ChunkDeDuplicate(items, params);
+            bench::Consume(chunked.store.ChunkCount());
+            ratio = chunked.store.Ratio();
+        }, 1);
+        add("chunks", avg, ratio, ns);
+    }
+
+    report.Print();
+    return 0;
+}
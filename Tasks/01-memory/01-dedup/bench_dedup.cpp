@@ -0,0 +1,89 @@
+// DeDuplicate на 10K, 1M и 10M строк.
+// Запуск: bench_dedup [max_items] > result.json
+// Строки вида "item-<число>-payload" длиной 14-22 байта, уникальных примерно
+// четверть. quadratic — прежний попарный перебор, его меряем только до 10K:
+// на 1M он не заканчивается за разумное время. parallel — DeDuplicate(items, threads)
+// на 2, 4 и 8 потоках; выигрыш ограничен числом ядер машины.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "dedup.h"
+
+namespace {
+
+std::vector<std::shared_ptr<string>> QuadraticDeDuplicate(
+    const std::vector<std::unique_ptr<string>>& items) {
+    std::vector<std::shared_ptr<string>> out(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        for (size_t j = 0; j < i && !out[i]; ++j) {
+            if (*out[j] == *items[i]) {
+                out[i] = out[j];
+            }
+        }
+        if (!out[i]) {
+            out[i] = std::make_shared<string>(*items[i]);
+        }
+    }
+    return out;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t max_items = 10'000'000;
+    if (argc > 1) {
+        max_items = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    std::fprintf(stderr, "hardware threads: %u\n", std::thread::hardware_concurrency());
+    bench::Report report("dedup");
+    std::mt19937_64 gen(20251010);
+    for (size_t size : {size_t{10'000}, size_t{1'000'000}, size_t{10'000'000}}) {
+        if (size > max_items) {
+            break;
+        }
+        std::vector<std::unique_ptr<string>> items(size);
+        for (auto& item : items) {
+            item = std::make_unique<string>("item-" + std::to_string(gen() % (size / 4 + 1)) +
+                                            "-payload");
+        }
+        const int repeats = size >= 10'000'000 ? 1 : 3;
+
+        auto add = [&](const char* impl, size_t threads, double ns) {
+            report.Add().Set("op", "dedup").Set("impl", impl).Set("threads", threads).Set(
+                "size", size).Set("ns_per_item", ns);
+        };
+
+        double hashed = bench::BestNsPerOp(
+            size, [&] { bench::Consume(DeDuplicate(items).size()); }, repeats);
+        add("hash", 1, hashed);
+        std::fprintf(stderr, "%9zu items: hash %8.1f ns/item\n", size, hashed);
+
+        if (size <= 10'000) {
+            double quadratic = bench::BestNsPerOp(size, [&] {
+                bench::Consume(QuadraticDeDuplicate(items).size());
+            }, repeats);
+            add("quadratic", 1, quadratic);
+            std::fprintf(stderr, "%9zu items: quadratic %8.1f ns/item\n", size, quadratic);
+        }
+
+        for (size_t threads : {2, 4, 8}) {
+            double parallel = bench::BestNsPerOp(size, [&] {
+                bench::Consume(DeDuplicate(items, threads).size());
+            }, repeats);
+            add("parallel", threads, parallel);
+            std::fprintf(stderr, "%9zu items: parallel x%zu %8.1f ns/item\n", size, threads,
+                         parallel);
+        }
+    }
+
+    report.Print();
+    return 0;
+}
@@ -0,0 +1,98 @@
+// Duplicate против DuplicateToArena: время и число аллокаций.
+// Запуск: bench_duplicate [items] > result.json
+// Строки по 8-16 байт (почти все в пределах SSO) и по 64-128 байт, выбранные
+// из пула размером в половину входа, так что многие значения повторяются. Аллокации считаются заменой глобального operator new.
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "dedup.h"
+
+namespace {
+
+std::atomic<size_t> allocations = 0;
+
+}  // namespace
+
+void* operator new(size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+// Время в нс на элемент и число аллокаций за один вызов body
+template <class Body>
+std::pair<double, size_t> Measure(size_t items, Body body) {
+    size_t count = 0;
+    double ns = bench::BestNsPerOp(items, [&] {
+        size_t before = allocations;
+        body();
+        count = allocations - before;
+    }, 3);
+    return {ns, count};
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t size = 1'000'000;
+    if (argc > 1) {
+        size = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    bench::Report report("duplicate");
+    std::mt19937_64 gen(20251013);
+    for (size_t length : {size_t{8}, size_t{64}}) {
+        std::vector<std::shared_ptr<string>> pool(size / 2 + 1);
+        for (auto& item : pool) {
+            item = std::make_shared<string>(length + gen() % (length + 1), '\0');
+            for (auto& c : *item) {
+                c = static_cast<char>('a' + gen() % 26);
+            }
+        }
+        std::vector<std::shared_ptr<string>> shared(size);
+        for (auto& item : shared) {
+            item = pool[gen() % pool.size()];
+        }
+
+        auto add = [&](const char* op, const char* impl, std::pair<double, size_t> m) {
+            report.Add().Set("op", op).Set("impl", impl).Set("size", size).Set(
+                "length", length).Set("ns_per_item", m.first).Set("allocations", m.second);
+            std::fprintf(stderr, "len %3zu %-10s %-16s %7.1f ns/item %9zu allocations\n",
+                         length, op, impl, m.first, m.second);
+        };
+        add("duplicate", "Duplicate",
+            Measure(size, [&] { bench::Consume(Duplicate(shared).size()); }));
+        add("duplicate", "DuplicateToArena",
+            Measure(size, [&] { bench::Consume(DuplicateToArena(shared).Size()); }));
+
+        auto unshared = Duplicate(shared);
+        auto arena = DuplicateToArena(shared);
+        add("dedup", "unique_ptr",
+            Measure(size, [&] { bench::Consume(DeDuplicate(unshared).size()); }));
+        add("dedup", "StringArena",
+            Measure(size, [&] { bench::Consume(DeDuplicate(arena).size()); }));
+    }
+
+    report.Print();
+    return 0;
+}
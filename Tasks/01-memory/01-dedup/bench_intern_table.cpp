@@ -0,0 +1,75 @@
+// Конкурентное интернирование в InternTable.
+// Запуск: bench_intern_table [ops_per_thread] > result.json
+// Каждый поток интернирует строки из общего пула в 100K значений пачками по
+// 1000 и держит пачку, пока не возьмётся за следующую, так что часть записей
+// всё время умирает. stripes = 1 — та же таблица под одним мьютексом.
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "intern_table.h"
+
+namespace {
+
+double Run(size_t stripes, size_t threads, size_t ops, const std::vector<string>& pool) {
+    InternTable table(stripes);
+    std::vector<size_t> totals(threads);
+    double ns = bench::BestNs([&] {
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                std::mt19937_64 gen(t);
+                std::vector<std::shared_ptr<const string>> batch;
+                size_t total = 0;
+                for (size_t i = 0; i < ops; ++i) {
+                    if (batch.size() == 1000) {
+                        batch.clear();
+                    }
+                    batch.push_back(table.Intern(pool[gen() % pool.size()]));
+                    total += batch.back()->size();
+                }
+                totals[t] = total;
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }, 1);
+    for (size_t total : totals) {
+        bench::Consume(total);
+    }
+    return ns / static_cast<double>(ops * threads);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t ops = 1'000'000;
+    if (argc > 1) {
+        ops = std::strtoull(argv[1], nullptr, 10);
+    }
+    std::vector<string> pool;
+    for (size_t i = 0; i < 100'000; ++i) {
+        pool.push_back("tenant-" + std::to_string(i % 97) + "/key-" + std::to_string(i));
+    }
+
+    std::fprintf(stderr, "hardware threads: %u\n", std::thread::hardware_concurrency());
+    bench::Report report("intern_table");
+    for (size_t stripes : {size_t{1}, InternTable::kDefaultStripes}) {
+        for (size_t threads : {1, 2, 4, 8}) {
+            double ns = Run(stripes, threads, ops, pool);
+            report.Add().Set("op", "intern").Set("impl", "InternTable").Set("stripes", stripes).Set(
+                "threads", threads).Set("ns_per_op", ns);
+            std::fprintf(stderr, "stripes %3zu threads %zu: %7.1f ns/op\n", stripes, threads, ns);
+        }
+    }
+
+    report.Print();
+    return 0;
+}
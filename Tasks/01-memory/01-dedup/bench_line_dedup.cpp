@@ -0,0 +1,117 @@
+// Дедупликация строк большого лог-файла.
+// Запуск: bench_line_dedup [size_mb] [unique_lines] > result.json
+// Файл генерируется во временном каталоге: строки вида
+// "2025-10-11 12:00:00 INFO worker-<k> request <m> done" из unique_lines вариантов.
+// mmap — ForEachUniqueLine по MappedFile; vector — чтение через std::getline в
+// vector<unique_ptr<string>> и DeDuplicate. anon_mb — прирост анонимной памяти
+// процесса (RssAnon) к концу прохода, пока таблица ещё жива.
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "dedup.h"
+#include "line_dedup.h"
+
+namespace {
+
+double RssAnonMb() {
+    std::ifstream status("/proc/self/status");
+    std::string key;
+    while (status >> key) {
+        if (key == "RssAnon:") {
+            double kb = 0;
+            status >> kb;
+            return kb / 1024;
+        }
+    }
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t size = size_t{256} << 20;
+    size_t unique = 100'000;
+    if (argc > 1) {
+        size = std::strtoull(argv[1], nullptr, 10) << 20;
+    }
+    if (argc > 2) {
+        unique = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    char path[] = "/tmp/bench_line_dedup_XXXXXX";
+    int fd = ::mkstemp(path);
+    if (fd < 0) {
+        std::perror("mkstemp");
+        return 1;
+    }
+    ::close(fd);
+    {
+        std::ofstream out(path, std::ios::binary);
+        std::mt19937_64 gen(20251011);
+        std::string line;
+        for (size_t written = 0; written < size; written += line.size()) {
+            size_t k = gen() % unique;
+            line = "2025-10-11 12:00:00 INFO worker-" + std::to_string(k % 64) + " request " +
+                   std::to_string(k) + " done\n";
+            out << line;
+        }
+    }
+
+    bench::Report report("line_dedup");
+    auto add = [&](const char* impl, size_t bytes, double ns, double anon_mb) {
+        double gb_per_s = static_cast<double>(bytes) / ns;
+        report.Add().Set("op", "unique_lines").Set("impl", impl).Set("size", bytes).Set(
+            "unique", unique).Set("gb_per_s", gb_per_s).Set("anon_mb", anon_mb);
+        std::fprintf(stderr, "%-7s %8.2f GB/s, anon %8.1f MB\n", impl, gb_per_s, anon_mb);
+    };
+
+    {
+        // освобождение памяти не входит в замер, поэтому всё живёт снаружи тела
+        std::optional<MappedFile> file;
+        LineDeduplicator dedup;
+        double anon = 0;
+        double ns = bench::BestNs([&] {
+            double before = RssAnonMb();
+            file.emplace(path);
+            ForEachLine(file->Text(), [&](std::string_view line) {
+                if (dedup.Add(line) == LineDeduplicator::kNew) {
+                    bench::Consume(line.size());
+                }
+            });
+            anon = RssAnonMb() - before;
+        }, 1);
+        add("mmap", file->Text().size(), ns, anon);
+    }
+    {
+        std::vector<std::unique_ptr<string>> lines;
+        std::vector<std::shared_ptr<string>> shared;
+        size_t bytes = 0;
+        double anon = 0;
+        double ns = bench::BestNs([&] {
+            double before = RssAnonMb();
+            std::ifstream in(path, std::ios::binary);
+            for (std::string line; std::getline(in, line);) {
+                bytes += line.size() + 1;
+                lines.push_back(std::make_unique<string>(std::move(line)));
+            }
+            shared = DeDuplicate(lines);
+            anon = RssAnonMb() - before;
+        }, 1);
+        bench::Consume(shared.size());
+        add("vector", bytes, ns, anon);
+    }
+    ::unlink(path);
+
+    report.Print();
+    return 0;
+}
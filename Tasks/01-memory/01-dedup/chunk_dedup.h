@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using std::string;
+
+// Дедупликация по кускам: строка режется на куски переменной длины по
+// содержимому (FastCDC с gear-хешем), и каждый уникальный кусок хранится один раз.
+// Границы кусков зависят только от соседних байт, поэтому вставка или удаление
+// в одном месте строки меняют один-два куска, а не все последующие.
+
+struct ChunkParams {
+    size_t min_size = 2048;
+    // степень двойки; средний размер куска получается около avg_size
+    size_t avg_size = 8192;
+    size_t max_size = 65536;
+};
+
+// Бросает std::invalid_argument, если с params границы кусков не определены
+inline void ValidateChunkParams(const ChunkParams& params) {
+    if (!std::has_single_bit(params.avg_size) || params.avg_size < 64 ||
+        params.min_size > params.avg_size || params.avg_size > params.max_size) {
+        throw std::invalid_argument(
+            "ChunkParams: need power-of-two avg_size >= 64 and min_size <= avg_size <= "
+            "max_size");
+    }
+}
+
+namespace chunk_dedup {
+
+constexpr std::array<uint64_t, 256> MakeGearTable() {
+    std::array<uint64_t, 256> table{};
+    uint64_t state = 0;
+    for (auto& value : table) {
+        // splitmix64
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        value = z ^ (z >> 31);
+    }
+    return table;
+}
+
+inline constexpr std::array<uint64_t, 256> kGear = MakeGearTable();
+
+// Маска из bits старших битов: после сдвигов влево в них сходятся
+// вклады последних 64 байт, младшие же зависят от пары последних байт
+constexpr uint64_t TopBits(int bits) {
+    return ~uint64_t{0} << (64 - bits);
+}
+
+// Длина первого куска data. До avg_size граница ищется по более строгой маске,
+// после — по более мягкой (normalized chunking): размеры кучнее вокруг среднего.
+// params должны пройти ValidateChunkParams; на непустых data результат не меньше 1.
+inline size_t CutPoint(std::string_view data, const ChunkParams& params) {
+    size_t size = data.size();
+    if (size <= params.min_size) {
+        return size;
+    }
+    if (size > params.max_size) {
+        size = std::max<size_t>(params.max_size, 1);
+    }
+    size_t normal = std::min(params.avg_size, size);
+    int bits = std::countr_zero(params.avg_size);
+    const uint64_t mask_small = TopBits(bits + 2);
+    const uint64_t mask_large = TopBits(bits - 2);
+
+    auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+    uint64_t fingerprint = 0;
+    size_t i = params.min_size;
+    for (; i < normal; ++i) {
+        fingerprint = (fingerprint << 1) + kGear[bytes[i]];
+        if (!(fingerprint & mask_small)) {
+            return i + 1;
+        }
+    }
+    for (; i < size; ++i) {
+        fingerprint = (fingerprint << 1) + kGear[bytes[i]];
+        if (!(fingerprint & mask_large)) {
+            return i + 1;
+        }
+    }
+    return size;
+}
+
+}  // namespace chunk_dedup
+
+// Вызывает on_chunk(chunk) для кусков data по порядку; все куски, кроме
+// последнего, имеют длину от min_size до max_size
+template <class OnChunk>
+void ForEachChunk(std::string_view data, const ChunkParams& params, OnChunk on_chunk) {
+    ValidateChunkParams(params);
+    while (!data.empty()) {
+        size_t cut = chunk_dedup::CutPoint(data, params);
+        on_chunk(data.substr(0, cut));
+        data.remove_prefix(cut);
+    }
+}
+
+// Хранилище уникальных кусков; строка в нём — список номеров кусков
+class ChunkStore {
+public:
+    using ChunkList = std::vector<uint32_t>;
+
+    explicit ChunkStore(ChunkParams params = {}) : params_(params) {
+        ValidateChunkParams(params_);
+    }
+
+    ChunkStore(const ChunkStore&) = delete;
+    ChunkStore& operator=(const ChunkStore&) = delete;
+    ChunkStore(ChunkStore&&) = default;
+    ChunkStore& operator=(ChunkStore&&) = default;
+
+    ChunkList Add(std::string_view data) {
+        ChunkList list;
+        ForEachChunk(data, params_, [&](std::string_view chunk) {
+            input_bytes_ += chunk.size();
+            auto it = ids_.find(chunk);
+            if (it == ids_.end()) {
+                it = ids_.emplace(chunk, static_cast<uint32_t>(chunks_.size())).first;
+                // ключи unordered_map не переезжают, на них можно ссылаться
+                chunks_.push_back(&it->first);
+                stored_bytes_ += chunk.size();
+            }
+            list.push_back(it->second);
+        });
+        references_ += list.size();
+        return list;
+    }
+
+    string Restore(const ChunkList& list) const {
+        size_t size = 0;
+        for (uint32_t id : list) {
+            size += chunks_[id]->size();
+        }
+        string out;
+        out.reserve(size);
+        for (uint32_t id : list) {
+            out += *chunks_[id];
+        }
+        return out;
+    }
+
+    std::string_view Chunk(uint32_t id) const {
+        return *chunks_[id];
+    }
+
+    size_t ChunkCount() const {
+        return chunks_.size();
+    }
+
+    // Сколько байт пришло в Add
+    size_t InputBytes() const {
+        return input_bytes_;
+    }
+
+    // Сколько байт занимают уникальные куски
+    size_t StoredBytes() const {
+        return stored_bytes_;
+    }
+
+    // Сколько байт занимают списки кусков
+    size_t ReferenceBytes() const {
+        return references_ * sizeof(uint32_t);
+    }
+
+    // Во сколько раз хранилище со списками меньше исходных строк
+    double Ratio() const {
+        size_t stored = StoredBytes() + ReferenceBytes();
+        return stored == 0 ? 1.0 : static_cast<double>(InputBytes()) / stored;
+    }
+
+private:
+    // Поиск по string_view без построения временной строки
+    struct Hash {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view chunk) const {
+            return std::hash<std::string_view>()(chunk);
+        }
+    };
+
+    ChunkParams params_;
+    std::unordered_map<string, uint32_t, Hash, std::equal_to<>> ids_;
+    std::vector<const string*> chunks_;
+    size_t input_bytes_ = 0;
+    size_t stored_bytes_ = 0;
+    size_t references_ = 0;
+};
+
+struct ChunkedStrings {
+    ChunkStore store;
+    std::vector<ChunkStore::ChunkList> items;
+};
+
+// Аналог DeDuplicate с общими кусками вместо общих строк целиком:
+// store.Restore(items[i]) == *input[i]
+inline ChunkedStrings ChunkDeDuplicate(const std::vector<std::unique_ptr<string>>& input,
+                                       ChunkParams params = {}) {
+    ChunkedStrings out{ChunkStore(params), {}};
+    out.items.reserve(input.size());
+    for (const auto& item : input) {
+        out.items.push_back(out.store.Add(*item));
+    }
+    return out;
+}
@@ -1,8 +1,15 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 using std::string;
 
@@ -16,26 +23,178 @@ std::vector<std::unique_ptr<string>> Duplicate(const std::vector<std::shared_ptr
     return out;
 }
 
+namespace dedup {
+
+// Число шардов не зависит от числа потоков: состав каждого шарда и порядок
+// элементов в нём одинаковы при любом threads, поэтому одинаков и ответ.
+constexpr size_t kShardBits = 8;
+constexpr size_t kShards = size_t{1} << kShardBits;
+// Меньше стольких элементов на поток запускать потоки дороже, чем считать
+constexpr size_t kMinItemsPerThread = 16384;
+
+inline size_t ShardOf(uint64_t hash) {
+    // биты для шарда — старшие, младшие остаются таблице внутри шарда
+    return hash >> (64 - kShardBits);
+}
+
+// Вызывает body(t) для t в [0, threads); t = 0 — в текущем потоке
+template <class Body>
+void RunParallel(size_t threads, Body body) {
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) {
+        workers.emplace_back(body, t);
+    }
+    body(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// Индекс по содержимому: ключ — string_view на строку, которой уже владеет
+// out, значение — позиция первого вхождения. Ключи не копируются.
+// Ожидаемое время O(n) вместо попарного сравнения с каждым предыдущим элементом.
+// view(i) — содержимое i-го элемента входа.
+template <class View>
+std::vector<std::shared_ptr<string>> DeDuplicateViews(size_t size, View view) {
+    std::vector<std::shared_ptr<string>> out(size);
+    std::unordered_map<std::string_view, size_t> seen;
+    seen.reserve(size);
+
+    for (size_t i = 0; i < size; ++i) {
+        std::string_view item = view(i);
+        auto found = seen.find(item);
+        if (found != seen.end()) {
+            out[i] = out[found->second];
+            continue;
+        }
+        out[i] = std::make_shared<string>(item);
+        seen.emplace(*out[i], i);
+    }
+
+    return out;
+}
+
+}  // namespace dedup
+
 std::vector<std::shared_ptr<string>> DeDuplicate(
     const std::vector<std::unique_ptr<string>>& items) {
-    std::vector<std::shared_ptr<string>> out(items.size());
+    return dedup::DeDuplicateViews(items.size(),
+                                   [&](size_t i) -> std::string_view { return *items[i]; });
+}
 
-    for (size_t i = 0; i < items.size(); ++i) {
-        bool flag = true;
-        size_t j = 0;
+// Результат Duplicate в одном буфере: символы всех строк подряд и массив
+// смещений. Две аллокации на весь вектор вместо двух на каждую строку;
+// строки отдаются как string_view и живут, пока жива арена.
+class StringArena {
+public:
+    StringArena() = default;
 
-        while (j < i) {
-            if (*out[j] == *items[i]) {
-                out[i] = out[j];
-                flag = false;
-            }
-            ++j;
+    explicit StringArena(const std::vector<std::shared_ptr<string>>& items)
+        : offsets_(items.size() + 1) {
+        for (size_t i = 0; i < items.size(); ++i) {
+            offsets_[i + 1] = offsets_[i] + items[i]->size();
+        }
+        chars_ = std::make_unique_for_overwrite<char[]>(offsets_.back());
+        for (size_t i = 0; i < items.size(); ++i) {
+            items[i]->copy(chars_.get() + offsets_[i], items[i]->size());
         }
+    }
 
-        if (flag) {
-            out[i] = std::make_shared<string>(*items[j]);
+    size_t Size() const {
+        return offsets_.empty() ? 0 : offsets_.size() - 1;
+    }
+
+    std::string_view operator[](size_t index) const {
+        return {chars_.get() + offsets_[index], offsets_[index + 1] - offsets_[index]};
+    }
+
+    // Суммарная длина строк
+    size_t Bytes() const {
+        return offsets_.empty() ? 0 : offsets_.back();
+    }
+
+private:
+    std::unique_ptr<char[]> chars_;
+    std::vector<size_t> offsets_;
+};
+
+StringArena DuplicateToArena(const std::vector<std::shared_ptr<string>>& items) {
+    return StringArena(items);
+}
+
+std::vector<std::shared_ptr<string>> DeDuplicate(const StringArena& items) {
+    return dedup::DeDuplicateViews(items.Size(), [&](size_t i) { return items[i]; });
+}
+
+// Параллельный вариант с тем же ответом, что и у DeDuplicate(items):
+//   1. потоки хешируют свои куски входа и считают, сколько элементов попало в каждый шард;
+//   2. по этим счётчикам элементы раскладываются по шардам, внутри шарда — в порядке входа;
+//   3. шарды разбираются независимо, каждый своей таблицей, out[i] пишется на место.
+// Первое вхождение значения всегда создаёт копию, остальные ссылаются на неё,
+// так что результат детерминирован и не зависит от threads.
+std::vector<std::shared_ptr<string>> DeDuplicate(
+    const std::vector<std::unique_ptr<string>>& items, size_t threads) {
+    using dedup::kShards;
+    using dedup::ShardOf;
+
+    const size_t n = items.size();
+    threads = std::min(threads, n / dedup::kMinItemsPerThread);
+    if (threads <= 1) {
+        return DeDuplicate(items);
+    }
+    auto chunk_begin = [&](size_t t) { return n * t / threads; };
+
+    std::vector<uint64_t> hashes(n);
+    // counts[t * kShards + s] — сначала число элементов потока t в шарде s,
+    // затем позиция, с которой поток t пишет свои элементы шарда s
+    std::vector<size_t> counts(threads * kShards);
+    dedup::RunParallel(threads, [&](size_t t) {
+        size_t* count = &counts[t * kShards];
+        for (size_t i = chunk_begin(t); i < chunk_begin(t + 1); ++i) {
+            hashes[i] = std::hash<std::string_view>()(*items[i]);
+            ++count[ShardOf(hashes[i])];
+        }
+    });
+
+    std::vector<size_t> shard_begin(kShards + 1);
+    size_t position = 0;
+    for (size_t s = 0; s < kShards; ++s) {
+        shard_begin[s] = position;
+        for (size_t t = 0; t < threads; ++t) {
+            size_t count = counts[t * kShards + s];
+            counts[t * kShards + s] = position;
+            position += count;
         }
     }
+    shard_begin[kShards] = n;
+
+    std::vector<size_t> order(n);
+    dedup::RunParallel(threads, [&](size_t t) {
+        size_t* next = &counts[t * kShards];
+        for (size_t i = chunk_begin(t); i < chunk_begin(t + 1); ++i) {
+            order[next[ShardOf(hashes[i])]++] = i;
+        }
+    });
+
+    // Таблица шарда хранит индексы первых вхождений; хеш уже посчитан
+    auto hash = [&](size_t i) { return static_cast<size_t>(hashes[i]); };
+    auto equal = [&](size_t i, size_t j) {
+        return hashes[i] == hashes[j] && *items[i] == *items[j];
+    };
+    std::vector<std::shared_ptr<string>> out(n);
+    std::atomic<size_t> next_shard = 0;
+    dedup::RunParallel(threads, [&](size_t) {
+        for (size_t s; (s = next_shard.fetch_add(1)) < kShards;) {
+            std::unordered_set<size_t, decltype(hash), decltype(equal)> seen(
+                shard_begin[s + 1] - shard_begin[s], hash, equal);
+            for (size_t k = shard_begin[s]; k < shard_begin[s + 1]; ++k) {
+                size_t i = order[k];
+                auto [first, inserted] = seen.insert(i);
+                out[i] = inserted ? std::make_shared<string>(*items[i]) : out[*first];
+            }
+        }
+    });
 
     return out;
 }
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using std::string;
+
+// Таблица интернирования строк, общая для всего процесса: равные строки из
+// разных вызовов DeDuplicate получают одну и ту же копию, пока она кому-то нужна.
+//
+// Таблица не владеет строками — в ней лежат weak_ptr, и строка освобождается,
+// когда умирает последний shared_ptr. Ключ — только хеш содержимого: ключ-string
+// хранил бы вторую копию, а string_view в умершую строку повис бы. Мёртвые
+// записи удаляются лениво — при встрече во время поиска и общим проходом по
+// шарду, когда он вырос вдвое с прошлой чистки.
+//
+// Записи разложены по kStripes шардам со своими мьютексами, так что потоки,
+// интернирующие разные строки, почти не ждут друг друга.
+class InternTable {
+public:
+    static constexpr size_t kDefaultStripes = 64;
+
+    explicit InternTable(size_t stripes = kDefaultStripes)
+        : stripes_(std::make_unique<Stripe[]>(stripes)), stripe_count_(stripes) {
+    }
+
+    InternTable(const InternTable&) = delete;
+    InternTable& operator=(const InternTable&) = delete;
+
+    // Таблица процесса
+    static InternTable& Global() {
+        static InternTable table;
+        return table;
+    }
+
+    // Живая строка, равная value, или новая, если такой нет
+    std::shared_ptr<const string> Intern(std::string_view value) {
+        size_t hash = std::hash<std::string_view>()(value);
+        Stripe& stripe = StripeOf(hash);
+        std::lock_guard lock(stripe.mutex);
+
+        auto [it, end] = stripe.entries.equal_range(hash);
+        while (it != end) {
+            if (auto live = it->second.lock()) {
+                if (*live == value) {
+                    return live;
+                }
+                ++it;
+            } else {
+                it = stripe.entries.erase(it);
+            }
+        }
+
+        auto fresh = std::make_shared<const string>(value);
+        stripe.entries.emplace(hash, fresh);
+        if (stripe.entries.size() >= 2 * stripe.live_after_sweep + kMinSweep) {
+            SweepLocked(stripe);
+        }
+        return fresh;
+    }
+
+    // Удаляет все мёртвые записи; возвращает их число
+    size_t Sweep() {
+        size_t removed = 0;
+        for (size_t s = 0; s < stripe_count_; ++s) {
+            std::lock_guard lock(stripes_[s].mutex);
+            removed += SweepLocked(stripes_[s]);
+        }
+        return removed;
+    }
+
+    // Число записей, включая ещё не удалённые мёртвые
+    size_t Size() const {
+        size_t size = 0;
+        for (size_t s = 0; s < stripe_count_; ++s) {
+            std::lock_guard lock(stripes_[s].mutex);
+            size += stripes_[s].entries.size();
+        }
+        return size;
+    }
+
+private:
+    // Шард меньше этого не чистится целиком: проход дороже, чем мусор
+    static constexpr size_t kMinSweep = 64;
+
+    struct alignas(64) Stripe {
+        mutable std::mutex mutex;
+        std::unordered_multimap<size_t, std::weak_ptr<const string>> entries;
+        size_t live_after_sweep = 0;
+    };
+
+    std::unique_ptr<Stripe[]> stripes_;
+    size_t stripe_count_;
+
+    Stripe& StripeOf(size_t hash) {
+        // младшие биты хеша уходят на корзины внутри шарда, здесь берём старшие
+        return stripes_[(hash >> 32) % stripe_count_];
+    }
+
+    static size_t SweepLocked(Stripe& stripe) {
+        size_t removed = std::erase_if(stripe.entries,
+                                       [](const auto& entry) { return entry.second.expired(); });
+        stripe.live_after_sweep = stripe.entries.size();
+        return removed;
+    }
+};
+
+// DeDuplicate, который делит строки не только внутри items, но и со всеми
+// живыми строками из table. Повторы внутри items сначала схлопываются
+// локально, так что мьютексы берутся по разу на уникальную строку.
+inline std::vector<std::shared_ptr<const string>> DeDuplicate(
+    const std::vector<std::unique_ptr<string>>& items, InternTable& table) {
+    std::vector<std::shared_ptr<const string>> out(items.size());
+    std::unordered_map<std::string_view, size_t> seen;
+    seen.reserve(items.size());
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        auto [found, inserted] = seen.try_emplace(*items[i], i);
+        out[i] = inserted ? table.Intern(*items[i]) : out[found->second];
+    }
+
+    return out;
+}
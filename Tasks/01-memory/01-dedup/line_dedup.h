@@ -0,0 +1,141 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+
+// Файл, целиком отображённый в память только для чтения.
+// Страницы подгружаются ядром по мере чтения и, будучи чистыми и привязанными
+// к файлу, могут быть вытеснены обратно, поэтому сам файл почти не занимает
+// анонимной памяти — сколько бы гигабайт в нём ни было.
+// MADV_SEQUENTIAL не ставится: ключи LineDeduplicator указывают в уже
+// прочитанные страницы, и ядро не должно выбрасывать их первыми.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "MappedFile: open " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) < 0) {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "MappedFile: fstat " + path);
+        }
+        // у каталога, канала или устройства размер не говорит, сколько там данных
+        if (!S_ISREG(st.st_mode)) {
+            ::close(fd);
+            throw std::invalid_argument("MappedFile: not a regular file: " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        // пустой файл отобразить нельзя — остаётся пустым текстом
+        if (size_ > 0) {
+            void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "MappedFile: mmap " + path);
+            }
+            data_ = static_cast<const char*>(data);
+        }
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (data_) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+    }
+
+    std::string_view Text() const {
+        return {data_, size_};
+    }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Дедупликация строк текста без копирования: ключи таблицы — string_view
+// прямо в текст (обычно в MappedFile), значение — номер первого вхождения.
+// Память растёт с числом уникальных строк, а не с размером текста.
+//
+// Строки разделяются '\n', сам разделитель в строку не входит; завершающий
+// '\n' не порождает пустой последней строки, как у std::getline.
+class LineDeduplicator {
+public:
+    static constexpr size_t kNew = static_cast<size_t>(-1);
+
+    // Номер первого вхождения line среди уже добавленных или kNew,
+    // если такой строки ещё не было. line должна жить не меньше *this.
+    size_t Add(std::string_view line) {
+        auto [it, inserted] = first_.try_emplace(line, lines_);
+        ++lines_;
+        return inserted ? kNew : it->second;
+    }
+
+    size_t LineCount() const {
+        return lines_;
+    }
+
+    size_t UniqueCount() const {
+        return first_.size();
+    }
+
+private:
+    std::unordered_map<std::string_view, size_t> first_;
+    size_t lines_ = 0;
+};
+
+// Вызывает on_line(line) для каждой строки text по порядку
+template <class OnLine>
+void ForEachLine(std::string_view text, OnLine on_line) {
+    const char* begin = text.data();
+    const char* end = begin + text.size();
+    while (begin != end) {
+        auto* newline = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+        const char* line_end = newline ? newline : end;
+        on_line(std::string_view(begin, line_end - begin));
+        begin = newline ? newline + 1 : end;
+    }
+}
+
+// Вызывает on_unique(line) для первого вхождения каждой строки, в порядке
+// появления; возвращает число строк в тексте
+template <class OnUnique>
+size_t ForEachUniqueLine(std::string_view text, OnUnique on_unique) {
+    LineDeduplicator dedup;
+    ForEachLine(text, [&](std::string_view line) {
+        if (dedup.Add(line) == LineDeduplicator::kNew) {
+            on_unique(line);
+        }
+    });
+    return dedup.LineCount();
+}
+
+// Вызывает on_line(first) для каждой строки, где first — номер первой строки
+// с тем же содержимым (для первого вхождения — номер самой строки);
+// возвращает число уникальных строк
+template <class OnLine>
+size_t ForEachFirstOccurrence(std::string_view text, OnLine on_line) {
+    LineDeduplicator dedup;
+    ForEachLine(text, [&](std::string_view line) {
+        size_t index = dedup.LineCount();
+        size_t first = dedup.Add(line);
+        on_line(first == LineDeduplicator::kNew ? index : first);
+    });
+    return dedup.UniqueCount();
+}
@@ -1,9 +1,22 @@
+#include <chunk_dedup.h>
 #include <dedup.h>
+#include <intern_table.h>
+#include <line_dedup.h>
 
 #include <catch.hpp>
 
-#include <string>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <random>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 using std::string;
 
@@ -66,3 +79,271 @@ TEST_CASE("More duplication") {
         REQUIRE(*unshared[i] == "abacaba");
     }
 }
+
+TEST_CASE("Deduping many strings") {
+    constexpr size_t kDistinct = 1000;
+    std::vector<std::unique_ptr<string>> unshared;
+    for (size_t i = 0; i < 100 * kDistinct; ++i) {
+        unshared.emplace_back(std::make_unique<string>(std::to_string(i * 7919 % kDistinct)));
+    }
+    unshared.emplace_back(std::make_unique<string>(""));
+    unshared.emplace_back(std::make_unique<string>(""));
+
+    auto shared = DeDuplicate(unshared);
+    REQUIRE(shared.size() == unshared.size());
+    for (size_t i = 0; i < shared.size(); ++i) {
+        REQUIRE(*shared[i] == *unshared[i]);
+    }
+    for (size_t i = kDistinct; i < 100 * kDistinct; ++i) {
+        REQUIRE(shared[i] == shared[i % kDistinct]);
+    }
+    REQUIRE(shared[100 * kDistinct] == shared[100 * kDistinct + 1]);
+    REQUIRE(shared[0].use_count() == 100);
+
+    auto again = Duplicate(shared);
+    for (size_t i = 0; i < again.size(); ++i) {
+        REQUIRE(*again[i] == *unshared[i]);
+    }
+}
+
+TEST_CASE("Parallel deduping") {
+    std::vector<std::unique_ptr<string>> unshared;
+    for (size_t i = 0; i < 200000; ++i) {
+        size_t value = i * 2654435761u % 50000;
+        unshared.emplace_back(std::make_unique<string>(string(value % 7, 'x') +
+                                                       std::to_string(value)));
+    }
+
+    // Для каждой позиции — позиция первого элемента с тем же указателем
+    auto sharing = [](const std::vector<std::shared_ptr<string>>& shared) {
+        std::unordered_map<const string*, size_t> first;
+        std::vector<size_t> pattern;
+        for (size_t i = 0; i < shared.size(); ++i) {
+            pattern.push_back(first.emplace(shared[i].get(), i).first->second);
+        }
+        return pattern;
+    };
+
+    auto expected = DeDuplicate(unshared);
+    for (size_t threads : {1, 2, 3, 8}) {
+        auto shared = DeDuplicate(unshared, threads);
+        REQUIRE(shared.size() == unshared.size());
+        for (size_t i = 0; i < shared.size(); ++i) {
+            REQUIRE(*shared[i] == *unshared[i]);
+        }
+        REQUIRE(sharing(shared) == sharing(expected));
+        REQUIRE(shared[0].use_count() == expected[0].use_count());
+    }
+
+    std::vector<std::unique_ptr<string>> empty;
+    REQUIRE(DeDuplicate(empty, 4).empty());
+}
+
+TEST_CASE("Deduping lines of a mapped file") {
+    char path[] = "/tmp/line_dedup_XXXXXX";
+    int fd = ::mkstemp(path);
+    REQUIRE(fd >= 0);
+    ::close(fd);
+
+    auto write = [&](const string& text) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << text;
+    };
+
+    write("foo\nbar\n\nbar\nbaz\nfoo\n\nfoo");
+    {
+        MappedFile file(path);
+        std::vector<string> unique;
+        size_t lines = ForEachUniqueLine(file.Text(),
+                                         [&](std::string_view line) { unique.emplace_back(line); });
+        REQUIRE(lines == 8);
+        REQUIRE(unique == std::vector<string>{"foo", "bar", "", "baz"});
+
+        std::vector<size_t> first;
+        size_t count = ForEachFirstOccurrence(file.Text(), [&](size_t i) { first.push_back(i); });
+        REQUIRE(count == 4);
+        REQUIRE(first == std::vector<size_t>{0, 1, 2, 1, 4, 0, 2, 0});
+    }
+
+    // завершающий перевод строки не даёт пустой последней строки
+    write("a\na\n");
+    {
+        MappedFile file(path);
+        std::vector<size_t> first;
+        ForEachFirstOccurrence(file.Text(), [&](size_t i) { first.push_back(i); });
+        REQUIRE(first == std::vector<size_t>{0, 0});
+    }
+
+    write("");
+    {
+        MappedFile file(path);
+        REQUIRE(file.Text().empty());
+        REQUIRE(ForEachUniqueLine(file.Text(), [](std::string_view) { FAIL(); }) == 0);
+    }
+
+    ::unlink(path);
+    REQUIRE_THROWS_AS(MappedFile(path), std::system_error);
+    REQUIRE_THROWS_AS(MappedFile("/dev/null"), std::invalid_argument);
+    REQUIRE_THROWS_AS(MappedFile("/"), std::invalid_argument);
+}
+
+TEST_CASE("Deduping chunks") {
+    std::mt19937_64 gen(46);
+    auto random_string = [&](size_t size) {
+        string text(size, '\0');
+        for (auto& c : text) {
+            c = static_cast<char>(gen());
+        }
+        return text;
+    };
+
+    ChunkParams params{256, 1024, 4096};
+    string base = random_string(1 << 18);
+    std::vector<size_t> sizes;
+    ForEachChunk(base, params, [&](std::string_view chunk) { sizes.push_back(chunk.size()); });
+    for (size_t i = 0; i + 1 < sizes.size(); ++i) {
+        REQUIRE(sizes[i] >= params.min_size);
+        REQUIRE(sizes[i] <= params.max_size);
+    }
+    REQUIRE(sizes.size() > 128);
+    REQUIRE(sizes.size() < 1024);
+
+    // Вставка и замена в середине меняют лишь соседние куски
+    string edited = base;
+    edited.insert(100000, "inserted");
+    edited[200000] ^= 1;
+
+    std::vector<std::unique_ptr<string>> items;
+    items.emplace_back(std::make_unique<string>(base));
+    items.emplace_back(std::make_unique<string>(edited));
+    items.emplace_back(std::make_unique<string>(base));
+    items.emplace_back(std::make_unique<string>(""));
+    items.emplace_back(std::make_unique<string>("short"));
+    items.emplace_back(std::make_unique<string>(random_string(5000)));
+
+    auto chunked = ChunkDeDuplicate(items, params);
+    REQUIRE(chunked.items.size() == items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        REQUIRE(chunked.store.Restore(chunked.items[i]) == *items[i]);
+    }
+    REQUIRE(chunked.items[0] == chunked.items[2]);
+    REQUIRE(chunked.items[3].empty());
+
+    const auto& store = chunked.store;
+    size_t input = 0;
+    for (const auto& item : items) {
+        input += item->size();
+    }
+    REQUIRE(store.InputBytes() == input);
+    REQUIRE(store.StoredBytes() < base.size() + 4 * params.max_size + 5005);
+    REQUIRE(store.Ratio() > 2.5);
+
+    REQUIRE_THROWS_AS(ChunkStore(ChunkParams{256, 1000, 4096}), std::invalid_argument);
+    REQUIRE_THROWS_AS(ChunkStore(ChunkParams{2048, 1024, 4096}), std::invalid_argument);
+    auto ignore = [](std::string_view) {};
+    REQUIRE_THROWS_AS(ForEachChunk(base, ChunkParams{0, 8192, 0}, ignore), std::invalid_argument);
+    REQUIRE_THROWS_AS(ForEachChunk(base, ChunkParams{0, 2, 4096}, ignore), std::invalid_argument);
+    REQUIRE_THROWS_AS(ForEachChunk(base, ChunkParams{256, 1000, 4096}, ignore),
+                      std::invalid_argument);
+}
+
+TEST_CASE("Duplicating into an arena") {
+    auto i0 = std::make_shared<string>("foo");
+    auto i1 = std::make_shared<string>("");
+    auto i2 = std::make_shared<string>(string(100, 'z'));
+    std::vector<std::shared_ptr<string>> shared = {i0, i1, i2, i0, i2, i1};
+
+    auto arena = DuplicateToArena(shared);
+    REQUIRE(arena.Size() == shared.size());
+    REQUIRE(arena.Bytes() == 206);
+    for (size_t i = 0; i < shared.size(); ++i) {
+        REQUIRE(arena[i] == *shared[i]);
+        REQUIRE(arena[i].data() != shared[i]->data());
+    }
+    // все символы лежат подряд в одном буфере
+    for (size_t i = 0; i + 1 < arena.Size(); ++i) {
+        REQUIRE(arena[i].data() + arena[i].size() == arena[i + 1].data());
+    }
+
+    auto again = DeDuplicate(arena);
+    REQUIRE(again.size() == shared.size());
+    for (size_t i = 0; i < shared.size(); ++i) {
+        REQUIRE(*again[i] == *shared[i]);
+    }
+    REQUIRE(again[0] == again[3]);
+    REQUIRE(again[2] == again[4]);
+    REQUIRE(again[1] == again[5]);
+    REQUIRE(again[0] != again[1]);
+
+    REQUIRE(DuplicateToArena({}).Size() == 0);
+    REQUIRE(StringArena().Size() == 0);
+    REQUIRE(DeDuplicate(StringArena()).empty());
+}
+
+TEST_CASE("Interning across batches") {
+    InternTable table(4);
+    auto batch = [](std::initializer_list<const char*> values) {
+        std::vector<std::unique_ptr<string>> items;
+        for (const char* value : values) {
+            items.emplace_back(std::make_unique<string>(value));
+        }
+        return items;
+    };
+
+    auto first = DeDuplicate(batch({"a", "b", "a"}), table);
+    auto second = DeDuplicate(batch({"b", "c", "a"}), table);
+    REQUIRE(*first[0] == "a");
+    REQUIRE(first[0] == first[2]);
+    REQUIRE(second[0] == first[1]);
+    REQUIRE(second[2] == first[0]);
+    REQUIRE(*second[1] == "c");
+    REQUIRE(table.Size() == 3);
+
+    // Пока строку держит хоть кто-то, она не пропадает
+    auto kept = second[1];
+    first.clear();
+    second.clear();
+    REQUIRE(table.Intern("c") == kept);
+    REQUIRE(table.Sweep() == 2);
+    REQUIRE(table.Size() == 1);
+
+    // Мёртвые записи удаляются и без Sweep
+    kept.reset();
+    for (int i = 0; i < 10000; ++i) {
+        table.Intern(std::to_string(i));
+    }
+    REQUIRE(table.Size() < 1000);
+    REQUIRE(table.Intern("") == table.Intern(""));
+
+    REQUIRE(&InternTable::Global() == &InternTable::Global());
+}
+
+TEST_CASE("Interning from many threads") {
+    InternTable table;
+    constexpr size_t kThreads = 8;
+    constexpr size_t kValues = 2000;
+    std::vector<std::vector<std::shared_ptr<const string>>> results(kThreads);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < kValues; ++i) {
+                results[t].push_back(table.Intern(std::to_string((i * 31 + t) % kValues)));
+                // часть строк сразу отпускаем, чтобы записи умирали на ходу
+                if (i % 3 == 0) {
+                    table.Intern("temporary-" + std::to_string(i));
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::unordered_map<string, const string*> canonical;
+    for (const auto& result : results) {
+        for (const auto& value : result) {
+            auto [it, inserted] = canonical.emplace(*value, value.get());
+            REQUIRE(it->second == value.get());
+        }
+    }
+    REQUIRE(canonical.size() == kValues);
+}
@@ -0,0 +1,143 @@
+// Хеширование и сравнение ключей StringView разной длины.
+// Запуск: bench_hash > result.json
+// На каждую длину — 4096 случайных ключей; равенство и сравнение проверяются
+// на парах, совпадающих во всём, кроме последнего байта, чтобы читался весь ключ.
+// map_find — поиск в unordered_map: у std::string ключ приходится строить
+// из StringView, у StringViewHash поиск идёт по самому StringView.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "bench.h"
+#include "string_view.h"
+
+namespace {
+
+}  // namespace
+
+int main() {
+    constexpr size_t kKeys = 4096;
+    bench::Report report("hash");
+    auto add = [&](const char* op, const char* impl, size_t len, double ns) {
+        report.Add().Set("op", op).Set("impl", impl).Set("size", len).Set("ns_per_op", ns);
+        std::fprintf(stderr, "%-10s %-18s %6zu %8.2f ns/op\n", op, impl, len, ns);
+    };
+
+    std::mt19937_64 gen(20251007);
+    for (size_t len : {4, 8, 16, 32, 64, 128, 256, 512, 1024, 4096}) {
+        std::vector<std::string> keys(kKeys);
+        std::vector<std::string> twins(kKeys);
+        for (size_t i = 0; i < kKeys; ++i) {
+            keys[i].resize(len);
+            for (auto& c : keys[i]) {
+                c = static_cast<char>(gen());
+            }
+            twins[i] = keys[i];
+            twins[i].back() ^= 1;
+        }
+        const size_t reps = std::max<size_t>(1, (size_t{1} << 24) / (kKeys * len));
+        const size_t ops = reps * kKeys;
+
+        add("hash", "StringView::Hash", len, bench::BestNsPerOp(ops, [&] {
+                uint64_t acc = 0;
+                for (size_t r = 0; r < reps; ++r) {
+                    for (const auto& key : keys) {
+                        acc += StringView(key).Hash();
+                    }
+                }
+                bench::Consume(acc);
+            }));
+        add("hash", "fnv1a", len, bench::BestNsPerOp(ops, [&] {
+                uint64_t acc = 0;
+                for (size_t r = 0; r < reps; ++r) {
+                    for (const auto& key : keys) {
+                        acc += string_hash::Fnv1a(key.data(), key.size());
+                    }
+                }
+                bench::Consume(acc);
+            }));
+        add("hash", "std::hash", len, bench::BestNsPerOp(ops, [&] {
+                uint64_t acc = 0;
+                for (size_t r = 0; r < reps; ++r) {
+                    for (const auto& key : keys) {
+                        acc += std::hash<std::string_view>()(key);
+                    }
+                }
+                bench::Consume(acc);
+            }));
+
+        add("equal", "StringView", len, bench::BestNsPerOp(ops, [&] {
+                size_t equal = 0;
+                for (size_t r = 0; r < reps; ++r) {
+                    for (size_t i = 0; i < kKeys; ++i) {
+                        equal += StringView(keys[i]) == StringView(twins[i]);
+                    }
+                }
+                bench::Consume(equal);
+            }));
+        add("equal", "std::string_view", len, bench::BestNsPerOp(ops, [&] {
+                size_t equal = 0;
+                for (size_t r = 0; r < reps; ++r) {
+                    for (size_t i = 0; i < kKeys; ++i) {
+                        equal += std::string_view(keys[i]) == std::string_view(twins[i]);
+                    }
+                }
+                bench::Consume(equal);
+            }));
+
+        add("compare", "StringView", len, bench::BestNsPerOp(ops, [&] {
+                int acc = 0;
+                for (size_t r = 0; r < reps; ++r) {
+                    for (size_t i = 0; i < kKeys; ++i) {
+                        acc += StringView(keys[i]).Compare(twins[i]) < 0;
+                    }
+                }
+                bench::Consume(acc);
+            }));
+        add("compare", "std::string_view", len, bench::BestNsPerOp(ops, [&] {
+                int acc = 0;
+                for (size_t r = 0; r < reps; ++r) {
+                    for (size_t i = 0; i < kKeys; ++i) {
+                        acc += std::string_view(keys[i]).compare(twins[i]) < 0;
+                    }
+                }
+                bench::Consume(acc);
+            }));
+
+        std::unordered_map<std::string, size_t> std_map;
+        std::unordered_map<std::string, size_t, StringViewHash, std::equal_to<>> our_map;
+        for (size_t i = 0; i < kKeys; ++i) {
+            std_map.emplace(keys[i], i);
+            our_map.emplace(keys[i], i);
+        }
+        std::vector<StringView> views(keys.begin(), keys.end());
+        add("map_find", "std::hash", len, bench::BestNsPerOp(ops, [&] {
+                size_t acc = 0;
+                for (size_t r = 0; r < reps; ++r) {
+                    for (StringView view : views) {
+                        acc += std_map.find(std::string(view.Data(), view.Size()))->second;
+                    }
+                }
+                bench::Consume(acc);
+            }));
+        add("map_find", "StringViewHash", len, bench::BestNsPerOp(ops, [&] {
+                size_t acc = 0;
+                for (size_t r = 0; r < reps; ++r) {
+                    for (StringView view : views) {
+                        acc += our_map.find(view)->second;
+                    }
+                }
+                bench::Consume(acc);
+            }));
+    }
+
+    report.Print();
+    return 0;
+}
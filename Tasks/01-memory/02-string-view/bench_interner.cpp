@@ -0,0 +1,98 @@
+// Много повторяющихся идентификаторов: отдельные std::string против StringInterner.
+// Запуск: bench_interner [count] [unique] > result.json
+// Идентификаторы вида "module.function_<k>" длиной 20-30 символов, k выбирается
+// равномерно из unique вариантов. Память std::string оценивается так же, как
+// в InternerStats::naive_bytes.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "string_interner.h"
+
+int main(int argc, char** argv) {
+    size_t count = 10'000'000;
+    size_t unique = 100'000;
+    if (argc > 1) {
+        count = std::strtoull(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        unique = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    std::vector<std::string> names(unique);
+    for (size_t k = 0; k < unique; ++k) {
+        names[k] = "service.module.function_" + std::to_string(k);
+    }
+    std::mt19937_64 gen(20251005);
+    std::vector<uint32_t> picks(count);
+    for (auto& pick : picks) {
+        pick = static_cast<uint32_t>(gen() % unique);
+    }
+
+    bench::Report report("interner");
+    auto add = [&](const char* op, const char* impl, double ns) {
+        report.Add().Set("op", op).Set("impl", impl).Set("size", count).Set("ns_per_op", ns);
+        std::fprintf(stderr, "%-8s %-16s %8.2f ns/op\n", op, impl, ns);
+    };
+
+    std::vector<std::string> strings;
+    strings.reserve(count);
+    add("store", "std::string", bench::BestNsPerOp(count, [&] {
+            for (uint32_t pick : picks) {
+                strings.emplace_back(names[pick]);
+            }
+        }, 1));
+
+    StringInterner pool;
+    std::vector<InternedString> interned;
+    interned.reserve(count);
+    add("store", "StringInterner", bench::BestNsPerOp(count, [&] {
+            for (uint32_t pick : picks) {
+                interned.push_back(pool.Intern(names[pick]));
+            }
+        }, 1));
+
+    add("equal", "std::string", bench::BestNsPerOp(count - 1, [&] {
+            size_t equal = 0;
+            for (size_t i = 1; i < count; ++i) {
+                equal += strings[i] == strings[i - 1];
+            }
+            bench::Consume(equal);
+        }, 1));
+    add("equal", "StringInterner", bench::BestNsPerOp(count - 1, [&] {
+            size_t equal = 0;
+            for (size_t i = 1; i < count; ++i) {
+                equal += interned[i] == interned[i - 1];
+            }
+            bench::Consume(equal);
+        }, 1));
+
+    add("find", "StringInterner", bench::BestNsPerOp(count, [&] {
+            size_t ids = 0;
+            for (uint32_t pick : picks) {
+                ids += pool.Find(names[pick]);
+            }
+            bench::Consume(ids);
+        }, 1));
+
+    size_t string_bytes = 0;
+    for (const auto& str : strings) {
+        string_bytes += sizeof(std::string) + (str.size() > 15 ? str.size() + 1 : 0);
+    }
+    auto stats = pool.Stats();
+    std::fprintf(stderr, "std::string: %zu bytes, interner: %zu bytes (arena %zu, index %zu)\n",
+                 string_bytes, stats.TotalBytes(), stats.arena_bytes, stats.index_bytes);
+
+    report.Add().Set("op", "memory").Set("impl", "std::string").Set("size", count).Set(
+        "bytes", string_bytes);
+    report.Add().Set("op", "memory").Set("impl", "StringInterner").Set("size", count).Set(
+        "bytes", stats.TotalBytes());
+    report.Print();
+    return 0;
+}
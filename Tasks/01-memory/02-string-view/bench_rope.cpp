@@ -0,0 +1,77 @@
+// Сборка ответа из кусков: склейка в std::string и write против RopeView::WriteTo.
+// Запуск: bench_rope [segments] > result.json
+// Ответ — заголовки по 30-40 байт плюс тело; пишем в /dev/null, так что
+// меряется именно подготовка данных и системный вызов, а не устройство.
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "rope_view.h"
+
+int main(int argc, char** argv) {
+    size_t headers = 16;
+    if (argc > 1) {
+        headers = std::strtoull(argv[1], nullptr, 10);
+    }
+    int fd = ::open("/dev/null", O_WRONLY);
+    if (fd < 0) {
+        std::perror("open /dev/null");
+        return 1;
+    }
+
+    std::vector<std::string> lines;
+    for (size_t i = 0; i < headers; ++i) {
+        lines.push_back("X-Header-" + std::to_string(i) + ": some header value\r\n");
+    }
+
+    bench::Report report("rope");
+    for (size_t body_size : {size_t{256}, size_t{4096}, size_t{65536}, size_t{1} << 20}) {
+        std::string body(body_size, 'x');
+        const size_t ops = std::max<size_t>(100, (size_t{1} << 26) / body_size / 16);
+
+        double concat = bench::BestNsPerOp(ops, [&] {
+            for (size_t i = 0; i < ops; ++i) {
+                std::string response = "HTTP/1.1 200 OK\r\n";
+                for (const auto& line : lines) {
+                    response += line;
+                }
+                response += "\r\n";
+                response += body;
+                if (::write(fd, response.data(), response.size()) < 0) {
+                    std::abort();
+                }
+            }
+        });
+        double rope = bench::BestNsPerOp(ops, [&] {
+            for (size_t i = 0; i < ops; ++i) {
+                RopeView response;
+                response.Reserve(lines.size() + 3);
+                response.Append("HTTP/1.1 200 OK\r\n");
+                for (const auto& line : lines) {
+                    response.Append(line);
+                }
+                response.Append("\r\n");
+                response.Append(body);
+                response.WriteTo(fd);
+            }
+        });
+        for (auto [impl, ns] : {std::pair{"std::string+write", concat},
+                                std::pair{"RopeView::WriteTo", rope}}) {
+            report.Add().Set("op", "respond").Set("impl", impl).Set("size", body_size).Set(
+                "ns_per_op", ns);
+        }
+        std::fprintf(stderr, "body %8zu: concat %10.1f ns, rope %10.1f ns\n", body_size, concat,
+                     rope);
+    }
+    ::close(fd);
+
+    report.Print();
+    return 0;
+}
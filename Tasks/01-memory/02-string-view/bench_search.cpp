@@ -0,0 +1,93 @@
+// Поиск в StringView против std::string_view.
+// Запуск: bench_search [max_size] > result.json
+// Текст — случайные строчные буквы, искомое лежит в самом конце,
+// так что каждый поиск проходит весь буфер. Путь (AVX2/SSE2/скалярный)
+// определяется флагами компиляции, например -march=native.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench.h"
+#include "string_view.h"
+
+namespace {
+
+// Короткие буферы прогоняются много раз, чтобы всего набралось ~256 МБ
+template <class Body>
+double BestGbPerS(size_t bytes, Body body) {
+    const size_t reps = std::max<size_t>(3, (size_t{1} << 28) / std::max<size_t>(bytes, 1));
+    return bench::BestGbPerS(bytes, body, static_cast<int>(reps));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t max_size = size_t{64} << 20;
+    if (argc > 1) {
+        max_size = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    bench::Report report("string_search");
+    auto add = [&](const char* op, const char* impl, size_t n, double gbs) {
+        report.Add().Set("op", op).Set("impl", impl).Set("size", n).Set("gb_per_s", gbs);
+        std::fprintf(stderr, "%-16s %-18s %10zu %8.2f GB/s\n", op, impl, n, gbs);
+    };
+
+    std::mt19937 gen(20251001);
+    for (size_t n = 64; n <= max_size; n *= 8) {
+        std::string text(n, ' ');
+        for (auto& c : text) {
+            c = static_cast<char>('a' + gen() % 26);
+        }
+        const std::string needle = "XYZZY";
+        text.replace(n - needle.size(), needle.size(), needle);
+        std::string prefix_copy = text;
+        prefix_copy.back() = '#';  // отличается только последним байтом
+
+        StringView ours(text);
+        std::string_view theirs(text);
+        StringView ours_copy(prefix_copy);
+        std::string_view theirs_copy(prefix_copy);
+
+        add("find_char", "StringView", n, BestGbPerS(n, [&] { bench::Consume(ours.Find('Y')); }));
+        add("find_char", "std::string_view", n,
+            BestGbPerS(n, [&] { bench::Consume(theirs.find('Y')); }));
+
+        add("find_substr", "StringView", n,
+            BestGbPerS(n, [&] { bench::Consume(ours.Find(StringView(needle))); }));
+        add("find_substr", "std::string_view", n,
+            BestGbPerS(n, [&] { bench::Consume(theirs.find(needle)); }));
+
+        add("rfind_char", "StringView", n, BestGbPerS(n, [&] { bench::Consume(ours.RFind('#')); }));
+        add("rfind_char", "std::string_view", n,
+            BestGbPerS(n, [&] { bench::Consume(theirs.rfind('#')); }));
+
+        add("find_first_of", "StringView", n,
+            BestGbPerS(n, [&] { bench::Consume(ours.FindFirstOf("XQ#!")); }));
+        add("find_first_of", "std::string_view", n,
+            BestGbPerS(n, [&] { bench::Consume(theirs.find_first_of("XQ#!")); }));
+
+        add("compare", "StringView", n, BestGbPerS(n, [&] {
+                bench::Consume(static_cast<size_t>(ours.Compare(ours_copy) + 1));
+            }));
+        add("compare", "std::string_view", n, BestGbPerS(n, [&] {
+                bench::Consume(static_cast<size_t>(theirs.compare(theirs_copy) + 1));
+            }));
+
+        add("starts_with", "StringView", n, BestGbPerS(n, [&] {
+                bench::Consume(ours.StartsWith(ours_copy.Substr(0, n - 1)));
+            }));
+        add("starts_with", "std::string_view", n, BestGbPerS(n, [&] {
+                bench::Consume(theirs.starts_with(theirs_copy.substr(0, n - 1)));
+            }));
+    }
+
+    report.Print();
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Разбиение большого буфера на токены: ленивый Split против
+// std::vector<std::string>, который обычно собирают через find + substr.
+// Запуск: bench_split [size] > result.json
+// Буфер — слова случайной длины от 1 до 16 через запятую; каждые
+// 8 слов — перевод строки, чтобы SplitAnyOf было что искать.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "string_split.h"
+
+namespace {
+
+std::vector<std::string> SplitToVector(const std::string& text, const std::string& delim) {
+    std::vector<std::string> tokens;
+    size_t start = 0;
+    while (true) {
+        size_t found = text.find(delim, start);
+        if (found == std::string::npos) {
+            tokens.push_back(text.substr(start));
+            return tokens;
+        }
+        tokens.push_back(text.substr(start, found - start));
+        start = found + delim.size();
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t size = size_t{1} << 30;
+    if (argc > 1) {
+        size = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    std::string text;
+    text.reserve(size + 32);
+    std::mt19937 gen(20251003);
+    for (size_t word = 0; text.size() < size; ++word) {
+        size_t len = 1 + gen() % 16;
+        for (size_t i = 0; i < len; ++i) {
+            text += static_cast<char>('a' + gen() % 26);
+        }
+        text += word % 8 == 7 ? '\n' : ',';
+    }
+    std::fprintf(stderr, "buffer: %zu bytes\n", text.size());
+
+    bench::Report report("split");
+    auto add = [&](const char* op, const char* impl, double gbs) {
+        report.Add().Set("op", op).Set("impl", impl).Set("size", text.size()).Set("gb_per_s", gbs);
+        std::fprintf(stderr, "%-12s %-14s %8.2f GB/s\n", op, impl, gbs);
+    };
+    const int reps = 3;
+
+    add("char", "Split", bench::BestGbPerS(text.size(), [&] {
+            size_t bytes = 0;
+            for (StringView token : Split(text, ',')) {
+                bytes += token.Size();
+            }
+            bench::Consume(bytes);
+        }, reps));
+    add("char", "vector<string>", bench::BestGbPerS(text.size(), [&] {
+            bench::Consume(SplitToVector(text, ",").size());
+        }, reps));
+
+    add("string", "Split", bench::BestGbPerS(text.size(), [&] {
+            size_t bytes = 0;
+            for (StringView token : Split(text, ",\n")) {
+                bytes += token.Size();
+            }
+            bench::Consume(bytes);
+        }, reps));
+    add("string", "vector<string>", bench::BestGbPerS(text.size(), [&] {
+            bench::Consume(SplitToVector(text, ",\n").size());
+        }, reps));
+
+    add("any_of", "SplitAnyOf", bench::BestGbPerS(text.size(), [&] {
+            size_t bytes = 0;
+            for (StringView token : SplitAnyOf(text, ",\n")) {
+                bytes += token.Size();
+            }
+            bench::Consume(bytes);
+        }, reps));
+
+    report.Print();
+    return 0;
+}
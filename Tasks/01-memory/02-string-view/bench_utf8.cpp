@@ -0,0 +1,111 @@
+// Проверка UTF-8 и подсчёт символов на двух корпусах.
+// Запуск: bench_utf8 [size] > result.json
+// ascii — английские слова из строчных букв, каждое сотое слово с «é»;
+// cjk — иероглифы из U+4E00..U+9FFF (по 3 байта) с пробелами и знаками
+// препинания ASCII примерно через каждые 8 символов.
+// byte_loop — посимвольный разбор через utf8::Decode без пропуска ASCII.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "utf8.h"
+
+namespace {
+
+void Append(std::string& out, char32_t c) {
+    if (c < 0x80) {
+        out += static_cast<char>(c);
+    } else if (c < 0x800) {
+        out += static_cast<char>(0xc0 | (c >> 6));
+        out += static_cast<char>(0x80 | (c & 0x3f));
+    } else {
+        out += static_cast<char>(0xe0 | (c >> 12));
+        out += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+        out += static_cast<char>(0x80 | (c & 0x3f));
+    }
+}
+
+std::string AsciiCorpus(size_t size, std::mt19937& gen) {
+    std::string text;
+    for (size_t word = 0; text.size() < size; ++word) {
+        size_t len = 2 + gen() % 8;
+        for (size_t i = 0; i < len; ++i) {
+            text += static_cast<char>('a' + gen() % 26);
+        }
+        if (word % 100 == 99) {
+            Append(text, U'é');
+        }
+        text += ' ';
+    }
+    return text;
+}
+
+std::string CjkCorpus(size_t size, std::mt19937& gen) {
+    std::string text;
+    for (size_t i = 0; text.size() < size; ++i) {
+        Append(text, 0x4e00 + gen() % 0x5200);
+        if (i % 8 == 7) {
+            text += gen() % 2 ? ' ' : ',';
+        }
+    }
+    return text;
+}
+
+bool ByteLoopValid(StringView text) {
+    for (size_t i = 0; i < text.Size();) {
+        auto decoded = utf8::Decode(text.Data() + i, text.Size() - i);
+        if (!decoded.valid) {
+            return false;
+        }
+        i += decoded.length;
+    }
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t size = size_t{64} << 20;
+    if (argc > 1) {
+        size = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    bench::Report report("utf8");
+    std::mt19937 gen(20251009);
+    for (const char* corpus : {"ascii", "cjk"}) {
+        std::string text = corpus[0] == 'a' ? AsciiCorpus(size, gen) : CjkCorpus(size, gen);
+        StringView view(text);
+        auto add = [&](const char* op, const char* impl, double gbs) {
+            report.Add().Set("op", op).Set("impl", impl).Set("corpus", corpus).Set(
+                "size", text.size()).Set("gb_per_s", gbs);
+            std::fprintf(stderr, "%-6s %-9s %-16s %8.2f GB/s\n", corpus, op, impl, gbs);
+        };
+
+        add("validate", "IsValidUtf8",
+            bench::BestGbPerS(text.size(), [&] { bench::Consume(IsValidUtf8(view)); }));
+        add("validate", "scalar", bench::BestGbPerS(text.size(), [&] {
+                bench::Consume(utf8::IsValidScalar(view.Data(), view.Size()));
+            }));
+        add("validate", "byte_loop",
+            bench::BestGbPerS(text.size(), [&] { bench::Consume(ByteLoopValid(view)); }));
+
+        add("count", "CountCodePoints",
+            bench::BestGbPerS(text.size(), [&] { bench::Consume(CountCodePoints(view)); }));
+        add("count", "CodePoints", bench::BestGbPerS(text.size(), [&] {
+                size_t count = 0;
+                for (char32_t c : CodePoints(view)) {
+                    count += c != 0;
+                }
+                bench::Consume(count);
+            }));
+    }
+
+    report.Print();
+    return 0;
+}
@@ -0,0 +1,331 @@
+#pragma once
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "string_view.h"
+
+// Строка, склеенная из нескольких StringView без копирования символов:
+//
+//     RopeView response = {status_line, headers, "\r\n", body};
+//     response.WriteTo(fd);  // один writev, без промежуточного буфера
+//
+// Первые kInlineSegments кусков хранятся прямо в объекте, дальше — в куче.
+// Для каждого куска запоминается смещение его конца, так что доступ по
+// индексу — двоичный поиск по кускам. RopeView не владеет символами:
+// как и StringView, он должен жить не дольше строк, на которые смотрит.
+class RopeView {
+public:
+    static constexpr size_t npos = StringView::npos;
+    static constexpr size_t kInlineSegments = 8;
+
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = char;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const char*;
+        using reference = char;
+
+        Iterator() = default;
+
+        char operator*() const {
+            return rope_->Segments()[segment_].view[offset_];
+        }
+
+        Iterator& operator++() {
+            if (++offset_ == rope_->Segments()[segment_].view.Size()) {
+                ++segment_;
+                offset_ = 0;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return segment_ == other.segment_ && offset_ == other.offset_;
+        }
+
+    private:
+        friend class RopeView;
+
+        const RopeView* rope_ = nullptr;
+        size_t segment_ = 0;
+        size_t offset_ = 0;
+
+        Iterator(const RopeView* rope, size_t segment, size_t offset)
+            : rope_(rope), segment_(segment), offset_(offset) {
+        }
+    };
+
+    RopeView() = default;
+
+    RopeView(std::initializer_list<StringView> segments) {
+        Reserve(segments.size());
+        for (StringView segment : segments) {
+            Append(segment);
+        }
+    }
+
+    RopeView(const RopeView& other) {
+        *this = other;
+    }
+
+    RopeView& operator=(const RopeView& other) {
+        if (this != &other) {
+            count_ = 0;
+            Reserve(other.count_);
+            std::copy(other.Segments(), other.Segments() + other.count_, Segments());
+            count_ = other.count_;
+        }
+        return *this;
+    }
+
+    RopeView(RopeView&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    RopeView& operator=(RopeView&& other) noexcept {
+        if (this != &other) {
+            if (other.heap_) {
+                heap_ = std::move(other.heap_);
+                capacity_ = other.capacity_;
+            } else {
+                heap_.reset();
+                capacity_ = kInlineSegments;
+                std::copy(other.inline_, other.inline_ + other.count_, inline_);
+            }
+            count_ = other.count_;
+            other.count_ = 0;
+            other.capacity_ = kInlineSegments;
+        }
+        return *this;
+    }
+
+    // Пустые куски не сохраняются
+    void Append(StringView segment) {
+        if (segment.Empty()) {
+            return;
+        }
+        if (count_ == capacity_) {
+            Reserve(2 * capacity_);
+        }
+        Segments()[count_] = {segment, Size() + segment.Size()};
+        ++count_;
+    }
+
+    void Reserve(size_t segments) {
+        if (segments <= capacity_) {
+            return;
+        }
+        auto heap = std::make_unique<Segment[]>(segments);
+        std::copy(Segments(), Segments() + count_, heap.get());
+        heap_ = std::move(heap);
+        capacity_ = segments;
+    }
+
+    void Clear() {
+        count_ = 0;
+    }
+
+    size_t Size() const {
+        return count_ == 0 ? 0 : Segments()[count_ - 1].end;
+    }
+
+    bool Empty() const {
+        return count_ == 0;
+    }
+
+    size_t SegmentCount() const {
+        return count_;
+    }
+
+    StringView SegmentAt(size_t index) const {
+        return Segments()[index].view;
+    }
+
+    char operator[](size_t index) const {
+        size_t segment = SegmentOf(index);
+        return Segments()[segment].view[index - Begin(segment)];
+    }
+
+    Iterator begin() const {
+        return Iterator(this, 0, 0);
+    }
+
+    Iterator end() const {
+        return Iterator(this, count_, 0);
+    }
+
+    // Первое вхождение needle, начинающееся не левее pos, в том числе
+    // перекрывающее границы кусков
+    size_t Find(StringView needle, size_t pos = 0) const {
+        if (pos > Size() || needle.Size() > Size() - pos) {
+            return npos;
+        }
+        if (needle.Empty()) {
+            return pos;
+        }
+        for (size_t segment = SegmentOf(pos); segment < count_; ++segment) {
+            StringView view = Segments()[segment].view;
+            size_t begin = Begin(segment);
+            size_t from = std::max(pos, begin) - begin;
+
+            // целиком внутри куска
+            size_t found = view.Find(needle, from);
+            if (found != StringView::npos) {
+                return begin + found;
+            }
+            // начинается в хвосте куска и продолжается в следующих
+            size_t tail = view.Size() >= needle.Size() ? view.Size() - needle.Size() + 1 : 0;
+            for (size_t start = std::max(from, tail); start < view.Size(); ++start) {
+                start = view.Find(needle[0], start);
+                if (start == StringView::npos) {
+                    break;
+                }
+                if (MatchesAt(segment, start, needle)) {
+                    return begin + start;
+                }
+            }
+        }
+        return npos;
+    }
+
+    size_t Find(char c, size_t pos = 0) const {
+        if (pos >= Size()) {
+            return npos;
+        }
+        for (size_t segment = SegmentOf(pos); segment < count_; ++segment) {
+            size_t begin = Begin(segment);
+            size_t found = Segments()[segment].view.Find(c, std::max(pos, begin) - begin);
+            if (found != StringView::npos) {
+                return begin + found;
+            }
+        }
+        return npos;
+    }
+
+    // Копирует все символы в out; capacity должно вмещать Size() байт
+    size_t Flatten(char* out, size_t capacity) const {
+        if (capacity < Size()) {
+            throw std::length_error("RopeView: buffer is too small");
+        }
+        for (size_t segment = 0; segment < count_; ++segment) {
+            StringView view = Segments()[segment].view;
+            std::memcpy(out, view.Data(), view.Size());
+            out += view.Size();
+        }
+        return Size();
+    }
+
+    std::string ToString() const {
+        std::string result(Size(), '\0');
+        Flatten(result.data(), result.size());
+        return result;
+    }
+
+    // Пишет всё содержимое в fd через writev, дописывая после частичных
+    // записей; кусков может быть больше IOV_MAX. Ошибки — std::system_error
+    void WriteTo(int fd) const {
+        constexpr size_t kBatch = std::min<size_t>(IOV_MAX, 64);
+        iovec iov[kBatch];
+        size_t segment = 0;
+        size_t offset = 0;  // уже записано из Segments()[segment]
+        while (segment < count_) {
+            size_t batch = 0;
+            for (size_t i = segment; i < count_ && batch < kBatch; ++i, ++batch) {
+                StringView view = Segments()[i].view;
+                size_t skip = i == segment ? offset : 0;
+                iov[batch].iov_base = const_cast<char*>(view.Data() + skip);
+                iov[batch].iov_len = view.Size() - skip;
+            }
+            ssize_t written = ::writev(fd, iov, static_cast<int>(batch));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "RopeView: writev");
+            }
+            // продвигаемся на written байт по кускам
+            size_t left = static_cast<size_t>(written);
+            while (left > 0) {
+                size_t rest = Segments()[segment].view.Size() - offset;
+                if (left < rest) {
+                    offset += left;
+                    break;
+                }
+                left -= rest;
+                ++segment;
+                offset = 0;
+            }
+        }
+    }
+
+private:
+    struct Segment {
+        StringView view;
+        // смещение конца куска в склеенной строке
+        size_t end = 0;
+    };
+
+    Segment inline_[kInlineSegments];
+    std::unique_ptr<Segment[]> heap_;
+    size_t count_ = 0;
+    size_t capacity_ = kInlineSegments;
+
+    Segment* Segments() {
+        return heap_ ? heap_.get() : inline_;
+    }
+
+    const Segment* Segments() const {
+        return heap_ ? heap_.get() : inline_;
+    }
+
+    size_t Begin(size_t segment) const {
+        return Segments()[segment].end - Segments()[segment].view.Size();
+    }
+
+    // Кусок, в котором лежит символ index; count_, если index >= Size()
+    size_t SegmentOf(size_t index) const {
+        const Segment* segments = Segments();
+        return std::upper_bound(segments, segments + count_, index,
+                                [](size_t i, const Segment& s) { return i < s.end; }) -
+               segments;
+    }
+
+    // Совпадает ли needle с содержимым начиная с offset в куске segment
+    bool MatchesAt(size_t segment, size_t offset, StringView needle) const {
+        size_t matched = 0;
+        while (matched < needle.Size()) {
+            if (segment == count_) {
+                return false;
+            }
+            StringView view = Segments()[segment].view;
+            size_t chunk = std::min(view.Size() - offset, needle.Size() - matched);
+            if (!(view.Substr(offset, chunk) == needle.Substr(matched, chunk))) {
+                return false;
+            }
+            matched += chunk;
+            ++segment;
+            offset = 0;
+        }
+        return true;
+    }
+};
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Хеши сырых буферов для StringView. Все функции constexpr, так что хеш
+// литерала можно получить на этапе компиляции.
+namespace string_hash {
+
+inline constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+inline constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+// FNV-1a: по байту за шаг. Оставлен как простой эталон для бенчмарков
+constexpr uint64_t Fnv1a(const char* data, size_t size, uint64_t seed = kFnvOffset) {
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+// Финализатор splitmix64: перемешивает все биты, чтобы младшие годились в индекс
+constexpr uint64_t Mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+// Чтение little-endian слов; на этапе компиляции — побайтово
+constexpr uint64_t Read64(const char* ptr) {
+    if (std::is_constant_evaluated()) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < 8; ++i) {
+            value |= uint64_t{static_cast<unsigned char>(ptr[i])} << (8 * i);
+        }
+        return value;
+    }
+    uint64_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+constexpr uint64_t Read32(const char* ptr) {
+    if (std::is_constant_evaluated()) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            value |= uint64_t{static_cast<unsigned char>(ptr[i])} << (8 * i);
+        }
+        return value;
+    }
+    uint32_t value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+// __extension__ глушит -Wpedantic: __int128 есть в GCC и Clang, но не в ISO C++
+__extension__ typedef unsigned __int128 U128;
+
+// Полное 128-битное произведение, свёрнутое xor-ом половин
+constexpr uint64_t MulFold(uint64_t lhs, uint64_t rhs) {
+    U128 product = static_cast<U128>(lhs) * rhs;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+inline constexpr uint64_t kWySecret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+                                          0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+// Хеш в духе wyhash: длинные строки идут по 48 байт за шаг тремя независимыми
+// цепочками по 16 байт, чтобы умножения шли параллельно; строки до 16 байт
+// читаются двумя-четырьмя перекрывающимися словами без цикла.
+constexpr uint64_t WyHash(const char* data, size_t size, uint64_t seed = 0) {
+    const uint64_t* secret = kWySecret;
+    seed ^= MulFold(seed ^ secret[0], secret[1]);
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (size <= 16) {
+        if (size >= 4) {
+            size_t middle = (size >> 3) << 2;
+            a = (Read32(data) << 32) | Read32(data + middle);
+            b = (Read32(data + size - 4) << 32) | Read32(data + size - 4 - middle);
+        } else if (size > 0) {
+            a = (uint64_t{static_cast<unsigned char>(data[0])} << 16) |
+                (uint64_t{static_cast<unsigned char>(data[size >> 1])} << 8) |
+                static_cast<unsigned char>(data[size - 1]);
+        }
+    } else {
+        const char* ptr = data;
+        size_t left = size;
+        if (left > 48) {
+            uint64_t lane1 = seed;
+            uint64_t lane2 = seed;
+            do {
+                seed = MulFold(Read64(ptr) ^ secret[1], Read64(ptr + 8) ^ seed);
+                lane1 = MulFold(Read64(ptr + 16) ^ secret[2], Read64(ptr + 24) ^ lane1);
+                lane2 = MulFold(Read64(ptr + 32) ^ secret[3], Read64(ptr + 40) ^ lane2);
+                ptr += 48;
+                left -= 48;
+            } while (left > 48);
+            seed ^= lane1 ^ lane2;
+        }
+        while (left > 16) {
+            seed = MulFold(Read64(ptr) ^ secret[1], Read64(ptr + 8) ^ seed);
+            ptr += 16;
+            left -= 16;
+        }
+        // последние 16 байт строки, возможно перекрываясь с уже прочитанными
+        a = Read64(ptr + left - 16);
+        b = Read64(ptr + left - 8);
+    }
+    a ^= secret[1];
+    b ^= seed;
+    U128 product = static_cast<U128>(a) * b;
+    a = static_cast<uint64_t>(product);
+    b = static_cast<uint64_t>(product >> 64);
+    return MulFold(a ^ secret[0] ^ size, b ^ secret[1]);
+}
+
+}  // namespace string_hash
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "string_hash.h"
+#include "string_view.h"
+
+// Интернированная строка: StringView в арену интернера и плотный номер.
+// Две строки из одного интернера равны тогда и только тогда, когда равны их id
+struct InternedString {
+    StringView view;
+    uint32_t id = 0;
+
+    bool operator==(const InternedString& other) const {
+        return id == other.id;
+    }
+};
+
+struct InternerStats {
+    // различных строк в пуле
+    size_t unique_strings = 0;
+    // вызовов Intern, включая повторы
+    size_t intern_calls = 0;
+    // байт символов во всех вызовах Intern
+    size_t requested_bytes = 0;
+    // байт символов, реально лежащих в арене
+    size_t stored_bytes = 0;
+    // выделено под арену, хеш-таблицы и таблицу id
+    size_t arena_bytes = 0;
+    size_t index_bytes = 0;
+    // столько заняли бы отдельные std::string на каждый вызов Intern
+    size_t naive_bytes = 0;
+
+    size_t TotalBytes() const {
+        return arena_bytes + index_bytes;
+    }
+
+    // сколько сэкономлено относительно отдельных std::string; может быть
+    // отрицательным, если почти все строки уникальны
+    ptrdiff_t SavedBytes() const {
+        return static_cast<ptrdiff_t>(naive_bytes) - static_cast<ptrdiff_t>(TotalBytes());
+    }
+};
+
+// Пул строк: каждая различная строка хранится один раз в больших кусках
+// арены и не двигается до разрушения пула, так что выданные StringView
+// остаются валидными.
+//
+// Find, Lookup и повторный Intern уже известной строки не берут блокировок
+// и безопасны параллельно друг с другом и с добавлением новых строк.
+// Добавления сериализуются мьютексом. Хеш-таблица — открытая адресация со
+// слотами atomic<const Entry*>; при росте новая таблица публикуется целиком,
+// а старые доживают до разрушения пула, потому что их ещё могут читать.
+class StringInterner {
+public:
+    static constexpr uint32_t kNotFound = static_cast<uint32_t>(-1);
+
+    explicit StringInterner(size_t chunk_size = size_t{1} << 20)
+        : chunk_size_(std::max(chunk_size, sizeof(Entry))) {
+        PublishTable(kInitialCapacity);
+    }
+
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    ~StringInterner() {
+        for (auto& segment : segments_) {
+            delete[] segment.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Возвращает строку из пула, добавляя её при первом обращении
+    InternedString Intern(StringView str) {
+        uint64_t hash = HashOf(str);
+        calls_.fetch_add(1, std::memory_order_relaxed);
+        requested_bytes_.fetch_add(str.Size(), std::memory_order_relaxed);
+        naive_bytes_.fetch_add(NaiveBytes(str.Size()), std::memory_order_relaxed);
+
+        if (const Entry* entry = FindEntry(str, hash)) {
+            return Make(entry);
+        }
+
+        std::lock_guard guard(mutex_);
+        // пока ждали мьютекс, строку мог добавить другой поток
+        if (const Entry* entry = FindEntry(str, hash)) {
+            return Make(entry);
+        }
+        if (size_ == kNotFound) {
+            throw std::length_error("StringInterner: too many strings");
+        }
+        const Entry* entry = Allocate(str, hash, static_cast<uint32_t>(size_));
+        // сначала id: кто найдёт строку в таблице, сможет сразу вызвать Lookup
+        StoreId(entry);
+        Insert(entry);
+        ++size_;
+        published_size_.store(size_, std::memory_order_release);
+        return Make(entry);
+    }
+
+    // id строки или kNotFound; ничего не добавляет
+    uint32_t Find(StringView str) const {
+        const Entry* entry = FindEntry(str, HashOf(str));
+        return entry == nullptr ? kNotFound : entry->id;
+    }
+
+    // Строка по id, полученному из этого пула
+    StringView Lookup(uint32_t id) const {
+        auto [segment, offset] = Locate(id);
+        return segments_[segment].load(std::memory_order_acquire)[offset]->View();
+    }
+
+    size_t Size() const {
+        return published_size_.load(std::memory_order_acquire);
+    }
+
+    InternerStats Stats() const {
+        std::lock_guard guard(mutex_);
+        InternerStats stats;
+        stats.unique_strings = size_;
+        stats.intern_calls = calls_.load(std::memory_order_relaxed);
+        stats.requested_bytes = requested_bytes_.load(std::memory_order_relaxed);
+        stats.naive_bytes = naive_bytes_.load(std::memory_order_relaxed);
+        stats.stored_bytes = stored_bytes_;
+        stats.arena_bytes = arena_bytes_;
+        for (const auto& table : tables_) {
+            stats.index_bytes += sizeof(Table) + table->capacity * sizeof(table->slots[0]);
+        }
+        for (size_t segment = 0; segment < kSegments; ++segment) {
+            if (segments_[segment].load(std::memory_order_relaxed) != nullptr) {
+                stats.index_bytes += SegmentSize(segment) * sizeof(const Entry*);
+            }
+        }
+        return stats;
+    }
+
+private:
+    // Заголовок строки в арене; символы лежат сразу за ним
+    struct Entry {
+        uint64_t hash;
+        uint32_t id;
+        uint32_t size;
+
+        StringView View() const {
+            return StringView(reinterpret_cast<const char*>(this + 1), size);
+        }
+    };
+
+    struct Table {
+        size_t capacity;
+        std::unique_ptr<std::atomic<const Entry*>[]> slots;
+    };
+
+    static constexpr size_t kInitialCapacity = 64;
+    // таблица id — сегменты удваивающегося размера, первый на 1024 строки;
+    // сегменты не двигаются, поэтому Lookup читает их без блокировки
+    static constexpr size_t kFirstSegmentLog = 10;
+    static constexpr size_t kSegments = 33 - kFirstSegmentLog;
+
+    size_t chunk_size_;
+
+    mutable std::mutex mutex_;
+    // всё ниже, кроме атомиков, меняется только под mutex_
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    char* chunk_pos_ = nullptr;
+    char* chunk_end_ = nullptr;
+    // текущая таблица последняя; предыдущие ещё могут читаться без блокировки
+    std::vector<std::unique_ptr<Table>> tables_;
+    std::atomic<const Table*> table_{nullptr};
+    std::atomic<const Entry**> segments_[kSegments] = {};
+    size_t size_ = 0;
+    size_t stored_bytes_ = 0;
+    size_t arena_bytes_ = 0;
+
+    std::atomic<size_t> published_size_{0};
+    std::atomic<size_t> calls_{0};
+    std::atomic<size_t> requested_bytes_{0};
+    std::atomic<size_t> naive_bytes_{0};
+
+    static uint64_t HashOf(StringView str) {
+        return str.Hash();
+    }
+
+    // std::string с SSO держит до 15 символов внутри себя
+    static size_t NaiveBytes(size_t size) {
+        return sizeof(std::string) + (size > 15 ? size + 1 : 0);
+    }
+
+    static InternedString Make(const Entry* entry) {
+        return {entry->View(), entry->id};
+    }
+
+    static size_t SegmentSize(size_t segment) {
+        return size_t{1} << (segment + kFirstSegmentLog);
+    }
+
+    // сегмент s хранит id из [2^(s + k) - 2^k, 2^(s + k + 1) - 2^k)
+    static std::pair<size_t, size_t> Locate(uint32_t id) {
+        size_t shifted = size_t{id} + (size_t{1} << kFirstSegmentLog);
+        size_t segment = std::bit_width(shifted) - 1 - kFirstSegmentLog;
+        return {segment, shifted - SegmentSize(segment)};
+    }
+
+    const Entry* FindEntry(StringView str, uint64_t hash) const {
+        const Table* table = table_.load(std::memory_order_acquire);
+        size_t mask = table->capacity - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            const Entry* entry = table->slots[i].load(std::memory_order_acquire);
+            if (entry == nullptr) {
+                return nullptr;
+            }
+            if (entry->hash == hash && entry->View() == str) {
+                return entry;
+            }
+        }
+    }
+
+    const Entry* Allocate(StringView str, uint64_t hash, uint32_t id) {
+        size_t bytes = sizeof(Entry) + (str.Size() + alignof(Entry) - 1) / alignof(Entry) *
+                                           alignof(Entry);
+        if (static_cast<size_t>(chunk_end_ - chunk_pos_) < bytes) {
+            // строки длиннее куска получают собственный кусок
+            size_t size = std::max(chunk_size_, bytes);
+            chunks_.emplace_back(new char[size]);
+            chunk_pos_ = chunks_.back().get();
+            chunk_end_ = chunk_pos_ + size;
+            arena_bytes_ += size;
+        }
+        Entry* entry = new (chunk_pos_) Entry{hash, id, static_cast<uint32_t>(str.Size())};
+        if (!str.Empty()) {
+            std::memcpy(entry + 1, str.Data(), str.Size());
+        }
+        chunk_pos_ += bytes;
+        stored_bytes_ += str.Size();
+        return entry;
+    }
+
+    void Insert(const Entry* entry) {
+        const Table* table = table_.load(std::memory_order_relaxed);
+        // заполнение не выше 1/2, иначе растём
+        if (2 * (size_ + 1) > table->capacity) {
+            table = PublishTable(2 * table->capacity);
+        }
+        Place(*table, entry);
+    }
+
+    static void Place(const Table& table, const Entry* entry) {
+        size_t mask = table.capacity - 1;
+        size_t i = entry->hash & mask;
+        while (table.slots[i].load(std::memory_order_relaxed) != nullptr) {
+            i = (i + 1) & mask;
+        }
+        table.slots[i].store(entry, std::memory_order_release);
+    }
+
+    // Строит таблицу на capacity слотов со всеми строками и публикует её
+    const Table* PublishTable(size_t capacity) {
+        auto table = std::make_unique<Table>();
+        table->capacity = capacity;
+        table->slots.reset(new std::atomic<const Entry*>[capacity]);
+        for (size_t i = 0; i < capacity; ++i) {
+            table->slots[i].store(nullptr, std::memory_order_relaxed);
+        }
+        for (uint32_t id = 0; id < size_; ++id) {
+            auto [segment, offset] = Locate(id);
+            Place(*table, segments_[segment].load(std::memory_order_relaxed)[offset]);
+        }
+        tables_.push_back(std::move(table));
+        table_.store(tables_.back().get(), std::memory_order_release);
+        return tables_.back().get();
+    }
+
+    void StoreId(const Entry* entry) {
+        auto [segment, offset] = Locate(entry->id);
+        const Entry** slots = segments_[segment].load(std::memory_order_relaxed);
+        if (slots == nullptr) {
+            slots = new const Entry*[SegmentSize(segment)];
+            segments_[segment].store(slots, std::memory_order_release);
+        }
+        slots[offset] = entry;
+    }
+};
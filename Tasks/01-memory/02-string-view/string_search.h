@@ -0,0 +1,276 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Поиск и сравнение сырых буферов для StringView.
+// Прямой поиск символа и подстроки, Compare и Equal длинных буферов отданы
+// std::char_traits, то есть memchr/memcmp из libc: они быстрее всего, что
+// здесь было написано руками. Свои векторные ядра остались там, где у libc
+// замены нет или она медленнее: обратный поиск, FindFirstOf и Equal коротких
+// буферов. Путь для них выбирается при компиляции: AVX2 (-mavx2 или
+// -march=native), иначе SSE2 (есть на любом x86-64), иначе скалярный код.
+// Все функции constexpr: при вычислении на этапе компиляции векторная часть
+// пропускается.
+namespace string_search {
+
+inline constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+#if defined(__AVX2__)
+#define STRING_SEARCH_HAS_SIMD 1
+
+// Блок из 32 байт; сравнения возвращают битовую маску совпавших байт
+struct Block {
+    static constexpr size_t kSize = 32;
+    static constexpr uint32_t kFullMask = 0xffffffff;
+
+    __m256i v;
+
+    static Block Load(const char* ptr) {
+        return {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr))};
+    }
+    static Block Splat(char c) {
+        return {_mm256_set1_epi8(c)};
+    }
+    uint32_t Eq(Block other) const {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, other.v)));
+    }
+    // байты, большие other как знаковые
+    uint32_t Gt(Block other) const {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(v, other.v)));
+    }
+};
+
+#elif defined(__SSE2__)
+#define STRING_SEARCH_HAS_SIMD 1
+
+// Блок из 16 байт; сравнения возвращают битовую маску совпавших байт
+struct Block {
+    static constexpr size_t kSize = 16;
+    static constexpr uint32_t kFullMask = 0xffff;
+
+    __m128i v;
+
+    static Block Load(const char* ptr) {
+        return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr))};
+    }
+    static Block Splat(char c) {
+        return {_mm_set1_epi8(c)};
+    }
+    uint32_t Eq(Block other) const {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, other.v)));
+    }
+    // байты, большие other как знаковые
+    uint32_t Gt(Block other) const {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(v, other.v)));
+    }
+};
+
+#else
+#define STRING_SEARCH_HAS_SIMD 0
+#endif
+
+template <class Word>
+Word LoadWord(const char* ptr) {
+    Word word;
+    std::memcpy(&word, ptr, sizeof(word));
+    return word;
+}
+
+// С этой длины memcmp догоняет свои ядра
+inline constexpr size_t kMemcmpEqualFrom = 256;
+
+// Равенство буферов. Короткие сравниваются двумя перекрывающимися словами
+// или блоками без вызова memcmp: на ключах хеш-таблиц это быстрее
+constexpr bool Equal(const char* lhs, const char* rhs, size_t size) {
+    if (std::is_constant_evaluated() || size >= kMemcmpEqualFrom) {
+        return std::char_traits<char>::compare(lhs, rhs, size) == 0;
+    }
+    if (size >= 8) {
+#if STRING_SEARCH_HAS_SIMD
+        if (size >= Block::kSize) {
+            size_t i = 0;
+            for (; i + 2 * Block::kSize <= size; i += 2 * Block::kSize) {
+                uint32_t m0 = Block::Load(lhs + i).Eq(Block::Load(rhs + i));
+                uint32_t m1 =
+                    Block::Load(lhs + i + Block::kSize).Eq(Block::Load(rhs + i + Block::kSize));
+                if ((m0 & m1) != Block::kFullMask) {
+                    return false;
+                }
+            }
+            if (i + Block::kSize <= size &&
+                Block::Load(lhs + i).Eq(Block::Load(rhs + i)) != Block::kFullMask) {
+                return false;
+            }
+            // хвост — последний блок, перекрывающийся с уже проверенными
+            size_t last = size - Block::kSize;
+            return Block::Load(lhs + last).Eq(Block::Load(rhs + last)) == Block::kFullMask;
+        }
+#endif
+        for (size_t i = 0; i + 8 < size; i += 8) {
+            if (LoadWord<uint64_t>(lhs + i) != LoadWord<uint64_t>(rhs + i)) {
+                return false;
+            }
+        }
+        return LoadWord<uint64_t>(lhs + size - 8) == LoadWord<uint64_t>(rhs + size - 8);
+    }
+    if (size >= 4) {
+        return (LoadWord<uint32_t>(lhs) == LoadWord<uint32_t>(rhs)) &
+               (LoadWord<uint32_t>(lhs + size - 4) == LoadWord<uint32_t>(rhs + size - 4));
+    }
+    for (size_t i = 0; i < size; ++i) {
+        if (lhs[i] != rhs[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Лексикографическое сравнение беззнаковых байт, как у memcmp: <0, 0 или >0
+constexpr int Compare(const char* lhs, const char* rhs, size_t size) {
+    return std::char_traits<char>::compare(lhs, rhs, size);
+}
+
+// Индекс первого c в [data, data + size) или kNotFound
+constexpr size_t FindChar(const char* data, size_t size, char c) {
+    const char* found = std::char_traits<char>::find(data, size, c);
+    return found == nullptr ? kNotFound : static_cast<size_t>(found - data);
+}
+
+// Индекс последнего c в [data, data + size) или kNotFound
+constexpr size_t RFindChar(const char* data, size_t size, char c) {
+    size_t i = size;
+#if STRING_SEARCH_HAS_SIMD
+    if (!std::is_constant_evaluated()) {
+        const Block needle = Block::Splat(c);
+        while (i >= 4 * Block::kSize) {
+            i -= 4 * Block::kSize;
+            uint32_t m0 = Block::Load(data + i).Eq(needle);
+            uint32_t m1 = Block::Load(data + i + Block::kSize).Eq(needle);
+            uint32_t m2 = Block::Load(data + i + 2 * Block::kSize).Eq(needle);
+            uint32_t m3 = Block::Load(data + i + 3 * Block::kSize).Eq(needle);
+            if ((m0 | m1 | m2 | m3) != 0) {
+                uint32_t masks[] = {m0, m1, m2, m3};
+                for (size_t k = 4; k-- > 0;) {
+                    if (masks[k] != 0) {
+                        return i + k * Block::kSize + 31 - __builtin_clz(masks[k]);
+                    }
+                }
+            }
+        }
+        while (i >= Block::kSize) {
+            i -= Block::kSize;
+            uint32_t mask = Block::Load(data + i).Eq(needle);
+            if (mask != 0) {
+                return i + 31 - __builtin_clz(mask);
+            }
+        }
+    }
+#endif
+    while (i > 0) {
+        --i;
+        if (data[i] == c) {
+            return i;
+        }
+    }
+    return kNotFound;
+}
+
+// Первое вхождение needle: memchr по первому символу среди позиций, где
+// needle ещё помещается, и memcmp остатка для каждого кандидата
+constexpr size_t FindSubstr(const char* data, size_t size, const char* needle,
+                            size_t needle_size) {
+    if (needle_size == 0) {
+        return 0;
+    }
+    size_t i = 0;
+    while (needle_size <= size - i) {
+        size_t candidate = FindChar(data + i, size - i - needle_size + 1, needle[0]);
+        if (candidate == kNotFound) {
+            return kNotFound;
+        }
+        i += candidate;
+        if (std::char_traits<char>::compare(data + i + 1, needle + 1, needle_size - 1) == 0) {
+            return i;
+        }
+        ++i;
+    }
+    return kNotFound;
+}
+
+// Последнее вхождение needle: идём назад по вхождениям первого символа
+constexpr size_t RFindSubstr(const char* data, size_t size, const char* needle,
+                             size_t needle_size) {
+    if (needle_size > size) {
+        return kNotFound;
+    }
+    if (needle_size == 0) {
+        return size;
+    }
+    size_t end = size - needle_size + 1;  // кандидаты лежат в [0, end)
+    while (end > 0) {
+        size_t candidate = RFindChar(data, end, needle[0]);
+        if (candidate == kNotFound) {
+            return kNotFound;
+        }
+        if (Equal(data + candidate, needle, needle_size)) {
+            return candidate;
+        }
+        end = candidate;
+    }
+    return kNotFound;
+}
+
+// Первый символ из множества set
+constexpr size_t FindFirstOf(const char* data, size_t size, const char* set,
+                             size_t set_size) {
+    if (set_size == 0) {
+        return kNotFound;
+    }
+    if (set_size == 1) {
+        return FindChar(data, size, set[0]);
+    }
+
+    size_t i = 0;
+#if STRING_SEARCH_HAS_SIMD
+    if (!std::is_constant_evaluated()) {
+        // для маленьких множеств сравниваем блок с каждым символом
+        constexpr size_t kMaxSimdSet = 8;
+        if (set_size <= kMaxSimdSet) {
+            Block splats[kMaxSimdSet];
+            for (size_t k = 0; k < set_size; ++k) {
+                splats[k] = Block::Splat(set[k]);
+            }
+            for (; i + Block::kSize <= size; i += Block::kSize) {
+                Block block = Block::Load(data + i);
+                uint32_t mask = 0;
+                for (size_t k = 0; k < set_size; ++k) {
+                    mask |= block.Eq(splats[k]);
+                }
+                if (mask != 0) {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+        }
+    }
+#endif
+    bool table[256] = {};
+    for (size_t k = 0; k < set_size; ++k) {
+        table[static_cast<unsigned char>(set[k])] = true;
+    }
+    for (; i < size; ++i) {
+        if (table[static_cast<unsigned char>(data[i])]) {
+            return i;
+        }
+    }
+    return kNotFound;
+}
+
+}  // namespace string_search
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+
+#include "string_search.h"
+#include "string_view.h"
+
+// Ленивое разбиение строки на токены без выделения памяти:
+//
+//     for (StringView token : Split(line, ',')) { ... }
+//
+// Токены — StringView внутрь исходной строки, следующий ищется только при
+// инкременте итератора. Семантика как у split в Python: пустые токены
+// сохраняются, пустая строка даёт один пустой токен, "a,b," — три токена.
+
+// Найденный разделитель: позиция и длина
+struct SplitMatch {
+    size_t pos;
+    size_t size;
+};
+
+// Один символ; поиск идёт через векторный FindChar
+struct CharDelimiter {
+    char delim;
+
+    constexpr SplitMatch Find(StringView text, size_t pos) const {
+        return {text.Find(delim, pos), 1};
+    }
+};
+
+// Подстрока целиком. Пустой разделитель не режет строку вовсе
+struct StringDelimiter {
+    StringView delim;
+
+    constexpr SplitMatch Find(StringView text, size_t pos) const {
+        if (delim.Empty()) {
+            return {StringView::npos, 0};
+        }
+        return {text.Find(delim, pos), delim.Size()};
+    }
+};
+
+// Любой символ из набора
+struct AnyOfDelimiter {
+    StringView chars;
+
+    constexpr SplitMatch Find(StringView text, size_t pos) const {
+        return {text.FindFirstOf(chars, pos), 1};
+    }
+};
+
+template <class Delimiter>
+class SplitRange {
+public:
+    class Iterator {
+    public:
+        using iterator_concept = std::forward_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = StringView;
+        using difference_type = std::ptrdiff_t;
+        using reference = StringView;
+
+        constexpr Iterator() = default;
+
+        constexpr StringView operator*() const {
+            return token_;
+        }
+
+        constexpr const StringView* operator->() const {
+            return &token_;
+        }
+
+        constexpr Iterator& operator++() {
+            size_t token_end = token_.Data() - range_->text_.Data() + token_.Size();
+            if (token_end == range_->text_.Size()) {
+                range_ = nullptr;
+            } else {
+                Load(token_end + next_skip_);
+            }
+            return *this;
+        }
+
+        constexpr Iterator operator++(int) {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        constexpr bool operator==(const Iterator& other) const {
+            return range_ == other.range_ &&
+                   (range_ == nullptr || token_.Data() == other.token_.Data());
+        }
+
+    private:
+        friend class SplitRange;
+
+        // nullptr — итератор за последним токеном
+        const SplitRange* range_ = nullptr;
+        StringView token_;
+        // длина разделителя, стоящего за token_
+        size_t next_skip_ = 0;
+
+        constexpr explicit Iterator(const SplitRange* range) : range_(range) {
+            Load(0);
+        }
+
+        constexpr void Load(size_t pos) {
+            const StringView& text = range_->text_;
+            SplitMatch match = range_->delim_.Find(text, pos);
+            if (match.pos == StringView::npos) {
+                token_ = StringView(text.Data() + pos, text.Size() - pos);
+                next_skip_ = 0;
+            } else {
+                token_ = StringView(text.Data() + pos, match.pos - pos);
+                next_skip_ = match.size;
+            }
+        }
+    };
+
+    constexpr SplitRange(StringView text, Delimiter delim) : text_(text), delim_(delim) {
+    }
+
+    constexpr Iterator begin() const {
+        return Iterator(this);
+    }
+
+    constexpr Iterator end() const {
+        return Iterator();
+    }
+
+private:
+    StringView text_;
+    Delimiter delim_;
+};
+
+// Диапазон хранит text по значению, а итераторы ссылаются на диапазон:
+// итерируйтесь, пока жив сам SplitRange (в range-for так и есть)
+constexpr SplitRange<CharDelimiter> Split(StringView text, char delim) {
+    return {text, CharDelimiter{delim}};
+}
+
+constexpr SplitRange<StringDelimiter> Split(StringView text, StringView delim) {
+    return {text, StringDelimiter{delim}};
+}
+
+constexpr SplitRange<AnyOfDelimiter> SplitAnyOf(StringView text, StringView chars) {
+    return {text, AnyOfDelimiter{chars}};
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "string_hash.h"
+#include "string_view.h"
+
+// Совершенный хеш над фиксированным набором строк, построенный на этапе компиляции.
+//
+//     constexpr StringSwitch kCommands({"get", "put", "delete"});
+//     switch (kCommands.Find(command)) {
+//         case kCommands.Find("get"): ...
+//         case kCommands.Find("put"): ...
+//         case StringSwitch<3>::kNotFound: ...
+//     }
+//
+// Find возвращает индекс ключа в исходном списке или kNotFound. Схема — hash and
+// displace: ключи раскладываются по группам, и для каждой группы подбирается
+// своя соль, при которой её ключи попадают в ещё свободные слоты таблицы.
+// Поиск — один хеш входа, одно перемешивание с солью и одно сравнение
+// с единственным кандидатом, чтобы отсеять строки не из набора.
+template <size_t N>
+class StringSwitch {
+    static_assert(N > 0, "StringSwitch needs at least one key");
+
+public:
+    static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+    constexpr explicit StringSwitch(const StringView (&keys)[N]) {
+        for (size_t i = 0; i < N; ++i) {
+            keys_[i] = keys[i];
+            for (size_t j = 0; j < i; ++j) {
+                if (keys_[i] == keys_[j]) {
+                    throw std::invalid_argument("StringSwitch: duplicate key");
+                }
+            }
+        }
+        for (uint64_t attempt = 1;; ++attempt) {
+            if (TryBuild(string_hash::Mix(attempt))) {
+                return;
+            }
+        }
+    }
+
+    constexpr size_t Size() const {
+        return N;
+    }
+
+    constexpr StringView Key(size_t index) const {
+        return keys_[index];
+    }
+
+    constexpr size_t Find(StringView key) const {
+        uint64_t hash = key.Hash(seed_);
+        uint32_t index = slots_[Slot(hash, salts_[Group(hash)])];
+        if (index != kEmpty && keys_[index] == key) {
+            return index;
+        }
+        return kNotFound;
+    }
+
+private:
+    // слотов вдвое больше ключей, групп — вдвое меньше: в среднем по два ключа на группу
+    static constexpr size_t kSlots = std::bit_ceil(2 * N);
+    static constexpr size_t kGroups = std::bit_ceil(N / 2 + 1);
+    static constexpr uint32_t kEmpty = static_cast<uint32_t>(-1);
+    // сколько солей пробовать на группу, прежде чем сменить seed_ целиком
+    static constexpr uint32_t kMaxSalt = 1u << 16;
+
+    std::array<StringView, N> keys_{};
+    std::array<uint32_t, kGroups> salts_{};
+    std::array<uint32_t, kSlots> slots_{};
+    uint64_t seed_ = 0;
+
+    // группа берётся из старших бит, слот — из хеша с солью группы
+    static constexpr size_t Group(uint64_t hash) {
+        return (hash >> 32) & (kGroups - 1);
+    }
+
+    static constexpr size_t Slot(uint64_t hash, uint32_t salt) {
+        return string_hash::Mix(hash ^ salt) & (kSlots - 1);
+    }
+
+    constexpr bool TryBuild(uint64_t seed) {
+        seed_ = seed;
+        slots_.fill(kEmpty);
+        salts_.fill(0);
+
+        // ключи, разложенные по группам подсчётом: группа g занимает
+        // members[begin[g]..begin[g + 1])
+        std::array<uint64_t, N> hashes{};
+        std::array<size_t, kGroups + 1> begin{};
+        for (size_t i = 0; i < N; ++i) {
+            hashes[i] = keys_[i].Hash(seed);
+            ++begin[Group(hashes[i]) + 1];
+        }
+        size_t max_group = 0;
+        for (size_t group = 0; group < kGroups; ++group) {
+            max_group = std::max(max_group, begin[group + 1]);
+            begin[group + 1] += begin[group];
+        }
+        std::array<size_t, N> members{};
+        std::array<size_t, kGroups> filled{};
+        for (size_t i = 0; i < N; ++i) {
+            size_t group = Group(hashes[i]);
+            members[begin[group] + filled[group]++] = i;
+        }
+
+        // большие группы размещаем первыми, пока таблица пустая
+        std::array<size_t, N> taken{};
+        for (size_t size = max_group; size > 0; --size) {
+            for (size_t group = 0; group < kGroups; ++group) {
+                if (begin[group + 1] - begin[group] != size) {
+                    continue;
+                }
+                if (!PlaceGroup(group, hashes, &members[begin[group]], size, taken)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    constexpr bool PlaceGroup(size_t group, const std::array<uint64_t, N>& hashes,
+                              const size_t* members, size_t size, std::array<size_t, N>& taken) {
+        for (uint32_t salt = 0; salt < kMaxSalt; ++salt) {
+            bool fits = true;
+            for (size_t k = 0; k < size && fits; ++k) {
+                taken[k] = Slot(hashes[members[k]], salt);
+                fits = slots_[taken[k]] == kEmpty;
+                for (size_t j = 0; j < k && fits; ++j) {
+                    fits = taken[j] != taken[k];
+                }
+            }
+            if (fits) {
+                salts_[group] = salt;
+                for (size_t k = 0; k < size; ++k) {
+                    slots_[taken[k]] = static_cast<uint32_t>(members[k]);
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+};
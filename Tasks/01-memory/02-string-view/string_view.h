@@ -1,36 +1,173 @@
 #pragma once
 
-#include <cstring>
+#include <algorithm>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
 #include <string>
 
+#include "string_hash.h"
+#include "string_search.h"
+
+// Весь интерфейс constexpr: StringView от литерала, поиск и хеш
+// можно вычислять на этапе компиляции
 class StringView {
 public:
-    StringView(const std::string& str, size_t start_pos = 0, size_t len_substr = std::string::npos)
-        : str_ptr(str.c_str()), start_pos(start_pos), len_substr(len_substr) {
-        if (start_pos + len_substr > str.length() || len_substr == std::string::npos) {
-            this->len_substr = str.length() - start_pos;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    constexpr StringView() : data_(nullptr), size_(0) {
+    }
+
+    constexpr StringView(const std::string& str, size_t start_pos = 0, size_t len_substr = npos) {
+        if (start_pos > str.size()) {
+            throw std::out_of_range("StringView: start_pos is out of range");
+        }
+        data_ = str.data() + start_pos;
+        size_ = std::min(len_substr, str.size() - start_pos);
+    }
+
+    constexpr StringView(const char* str)
+        : data_(str), size_(std::char_traits<char>::length(str)) {
+    }
+
+    // len берётся как есть: буфер не обязан заканчиваться нулём
+    constexpr StringView(const char* str, size_t len) : data_(str), size_(len) {
+    }
+
+    constexpr char operator[](size_t index) const {
+        return data_[index];
+    }
+
+    constexpr const char* Data() const {
+        return data_;
+    }
+
+    constexpr size_t Size() const {
+        return size_;
+    }
+
+    constexpr bool Empty() const {
+        return size_ == 0;
+    }
+
+    constexpr StringView Substr(size_t pos, size_t count = npos) const {
+        if (pos > size_) {
+            throw std::out_of_range("StringView: pos is out of range");
         }
+        return StringView(data_ + pos, std::min(count, size_ - pos));
     }
 
-    StringView(const char* str) : str_ptr(str), start_pos(0), len_substr(std::string::npos) {
-        this->len_substr = std::strlen(str_ptr);
+    // Поиск возвращает позицию в этом StringView или npos
+    constexpr size_t Find(StringView needle, size_t pos = 0) const {
+        if (pos > size_) {
+            return npos;
+        }
+        return Shift(
+            string_search::FindSubstr(data_ + pos, size_ - pos, needle.data_, needle.size_), pos);
     }
 
-    StringView(const char* str, size_t len) : str_ptr(str), start_pos(0), len_substr(len) {
-        if (len_substr > std::strlen(str_ptr)) {
-            this->len_substr = std::strlen(str_ptr);
+    constexpr size_t Find(char c, size_t pos = 0) const {
+        if (pos >= size_) {
+            return npos;
         }
+        return Shift(string_search::FindChar(data_ + pos, size_ - pos, c), pos);
     }
 
-    char operator[](size_t index) const {
-        return str_ptr[start_pos + index];
+    // Последнее вхождение, начинающееся не правее pos
+    constexpr size_t RFind(StringView needle, size_t pos = npos) const {
+        if (needle.size_ > size_) {
+            return npos;
+        }
+        size_t last_start = std::min(pos, size_ - needle.size_);
+        return string_search::RFindSubstr(data_, last_start + needle.size_, needle.data_,
+                                          needle.size_);
+    }
+
+    constexpr size_t RFind(char c, size_t pos = npos) const {
+        if (size_ == 0) {
+            return npos;
+        }
+        return string_search::RFindChar(data_, std::min(pos, size_ - 1) + 1, c);
     }
 
-    size_t Size() const {
-        return len_substr;
+    // Первый символ, входящий в chars
+    constexpr size_t FindFirstOf(StringView chars, size_t pos = 0) const {
+        if (pos >= size_) {
+            return npos;
+        }
+        return Shift(
+            string_search::FindFirstOf(data_ + pos, size_ - pos, chars.data_, chars.size_), pos);
     }
 
-    const char* str_ptr;
-    size_t start_pos;
-    size_t len_substr;
+    constexpr size_t FindFirstOf(char c, size_t pos = 0) const {
+        return Find(c, pos);
+    }
+
+    // Лексикографическое сравнение: <0, 0 или >0
+    constexpr int Compare(StringView other) const {
+        size_t common = std::min(size_, other.size_);
+        if (common > 0) {
+            int result = string_search::Compare(data_, other.data_, common);
+            if (result != 0) {
+                return result;
+            }
+        }
+        if (size_ == other.size_) {
+            return 0;
+        }
+        return size_ < other.size_ ? -1 : 1;
+    }
+
+    constexpr bool StartsWith(StringView prefix) const {
+        return prefix.size_ <= size_ && string_search::Equal(data_, prefix.data_, prefix.size_);
+    }
+
+    constexpr bool StartsWith(char c) const {
+        return size_ > 0 && data_[0] == c;
+    }
+
+    constexpr bool EndsWith(StringView suffix) const {
+        return suffix.size_ <= size_ &&
+               string_search::Equal(data_ + size_ - suffix.size_, suffix.data_, suffix.size_);
+    }
+
+    constexpr bool operator==(StringView other) const {
+        return size_ == other.size_ && string_search::Equal(data_, other.data_, size_);
+    }
+
+    constexpr std::strong_ordering operator<=>(StringView other) const {
+        return Compare(other) <=> 0;
+    }
+
+    // wyhash-подобный хеш; для литералов считается на этапе компиляции
+    constexpr uint64_t Hash(uint64_t seed = 0) const {
+        return string_hash::WyHash(data_, size_, seed);
+    }
+
+private:
+    const char* data_;
+    size_t size_;
+
+    static constexpr size_t Shift(size_t found, size_t pos) {
+        return found == string_search::kNotFound ? npos : found + pos;
+    }
 };
+
+// "abc"_sv: длина известна без обхода строки
+constexpr StringView operator""_sv(const char* str, size_t len) {
+    return StringView(str, len);
+}
+
+// Хеш для unordered-контейнеров. Прозрачный: в контейнере с ключом std::string
+// и std::equal_to<> можно искать по StringView без построения строки
+struct StringViewHash {
+    using is_transparent = void;
+
+    size_t operator()(StringView str) const {
+        return str.Hash();
+    }
+};
+
+template <>
+struct std::hash<StringView> : StringViewHash {};
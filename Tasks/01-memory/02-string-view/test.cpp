@@ -1,8 +1,24 @@
 #include <catch.hpp>
+#include <unistd.h>
 #include <util.h>
 #include <string_view.h>
+#include <rope_view.h>
+#include <string_interner.h>
+#include <string_split.h>
+#include <string_switch.h>
+#include <utf8.h>
+#include <allocations_checker.h>
 
+#include <algorithm>
+#include <memory>
+#include <ranges>
+#include <map>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <string>
+#include <vector>
 
 TEST_CASE("Constructors") {
     {
@@ -56,3 +72,648 @@ TEST_CASE("Big") {
 
     REQUIRE(count - 1 == static_cast<int>(s.Size()));
 }
+
+TEST_CASE("Data and Substr") {
+    std::string a("abacaba");
+    StringView s(a);
+    REQUIRE(s.Data() == a.data());
+    REQUIRE(!s.Empty());
+
+    StringView sub = s.Substr(2, 3);
+    REQUIRE(sub.Data() == a.data() + 2);
+    REQUIRE(sub.Size() == 3u);
+    REQUIRE(sub[0] == 'a');
+    REQUIRE(sub[1] == 'c');
+
+    REQUIRE(s.Substr(5).Size() == 2u);
+    REQUIRE(s.Substr(7).Empty());
+    REQUIRE_THROWS_AS(s.Substr(8), std::out_of_range);
+
+    StringView buffer("abc\0def", 7);
+    REQUIRE(buffer.Size() == 7u);
+    REQUIRE(buffer.Find('d') == 4u);
+}
+
+TEST_CASE("Find family") {
+    StringView s("hello, world, hello");
+    REQUIRE(s.Find("hello") == 0u);
+    REQUIRE(s.Find("hello", 1) == 14u);
+    REQUIRE(s.Find("bye") == StringView::npos);
+    REQUIRE(s.Find('w') == 7u);
+    REQUIRE(s.Find("") == 0u);
+    REQUIRE(s.Find("", s.Size()) == s.Size());
+    REQUIRE(s.RFind("hello") == 14u);
+    REQUIRE(s.RFind("hello", 13) == 0u);
+    REQUIRE(s.RFind('o') == 18u);
+    REQUIRE(s.RFind('o', 17) == 8u);
+    REQUIRE(s.FindFirstOf(",!") == 5u);
+    REQUIRE(s.FindFirstOf("xyz") == StringView::npos);
+    REQUIRE(s.StartsWith("hello,"));
+    REQUIRE(s.StartsWith('h'));
+    REQUIRE(!s.StartsWith("world"));
+    REQUIRE(s.EndsWith("hello"));
+    REQUIRE(StringView("").Find('a') == StringView::npos);
+    REQUIRE(StringView("").RFind('a') == StringView::npos);
+}
+
+TEST_CASE("Compare") {
+    REQUIRE(StringView("abc").Compare("abc") == 0);
+    REQUIRE(StringView("abc").Compare("abd") < 0);
+    REQUIRE(StringView("abd").Compare("abc") > 0);
+    REQUIRE(StringView("ab").Compare("abc") < 0);
+    REQUIRE(StringView("abc").Compare("ab") > 0);
+    REQUIRE(StringView("").Compare("") == 0);
+    REQUIRE(StringView("\xff").Compare("a") > 0);
+}
+
+TEST_CASE("Search matches std::string") {
+    RandomGenerator rnd(85034);
+    for (int iter = 0; iter < 2000; ++iter) {
+        auto hay = rnd.GenString(rnd.GenInt(0, 200), 'a', 'c');
+        auto needle = rnd.GenString(rnd.GenInt(0, 5), 'a', 'c');
+        size_t pos = rnd.GenInt<size_t>(0, hay.size() + 1);
+        StringView s(hay);
+        StringView n(needle);
+
+        REQUIRE(s.Find(n, pos) == hay.find(needle, pos));
+        REQUIRE(s.RFind(n, pos) == hay.rfind(needle, pos));
+        REQUIRE(s.RFind(n) == hay.rfind(needle));
+        REQUIRE(s.FindFirstOf(n, pos) == hay.find_first_of(needle, pos));
+        if (!needle.empty()) {
+            REQUIRE(s.Find(needle[0], pos) == hay.find(needle[0], pos));
+            REQUIRE(s.RFind(needle[0], pos) == hay.rfind(needle[0], pos));
+        }
+
+        int expected = hay.compare(needle);
+        int actual = s.Compare(n);
+        REQUIRE((expected < 0) == (actual < 0));
+        REQUIRE((expected > 0) == (actual > 0));
+        REQUIRE(s.StartsWith(n) == (hay.compare(0, needle.size(), needle) == 0));
+    }
+
+    // большое множество символов идёт через таблицу
+    std::string text(1000, 'x');
+    text[777] = '9';
+    REQUIRE(StringView(text).FindFirstOf("0123456789") == 777u);
+}
+
+TEST_CASE("Constexpr") {
+    static_assert(StringView("abacaba").Size() == 7);
+    static_assert(StringView("abacaba")[3] == 'c');
+    static_assert("abacaba"_sv.Substr(2, 3) == "aca");
+    static_assert(StringView("hello, world").Find("world") == 7);
+    static_assert(StringView("hello, world").RFind('o') == 8);
+    static_assert(StringView("hello, world").FindFirstOf(" ,") == 5);
+    static_assert(StringView("abc").Compare("abd") < 0);
+    static_assert(StringView("abc").EndsWith("bc"));
+    static_assert("abc"_sv.Hash() == StringView("abc").Hash());
+    static_assert("abc"_sv.Hash() != "abd"_sv.Hash());
+
+    // хеш на этапе компиляции совпадает с рантаймовым
+    std::string abc = "abc";
+    REQUIRE(StringView(abc).Hash() == "abc"_sv.Hash());
+    REQUIRE(StringView(abc).Hash(42) != StringView(abc).Hash());
+}
+
+TEST_CASE("StringSwitch") {
+    static constexpr StringSwitch kMethods({"GET", "PUT", "POST", "DELETE", "HEAD", "OPTIONS"});
+    static_assert(kMethods.Find("GET") == 0);
+    static_assert(kMethods.Find("OPTIONS") == 5);
+    static_assert(kMethods.Find("get") == kMethods.kNotFound);
+    static_assert(kMethods.Find("") == kMethods.kNotFound);
+
+    auto dispatch = [](StringView method) {
+        switch (kMethods.Find(method)) {
+            case kMethods.Find("GET"):
+                return 1;
+            case kMethods.Find("POST"):
+                return 2;
+            default:
+                return 0;
+        }
+    };
+    std::string post = "POST";
+    REQUIRE(dispatch(post) == 2);
+    REQUIRE(dispatch("GET") == 1);
+    REQUIRE(dispatch("HEAD") == 0);
+    REQUIRE(dispatch("GETS") == 0);
+
+    for (size_t i = 0; i < kMethods.Size(); ++i) {
+        std::string key(kMethods.Key(i).Data(), kMethods.Key(i).Size());
+        REQUIRE(kMethods.Find(key) == i);
+    }
+
+    REQUIRE_THROWS_AS(StringSwitch({"a", "b", "a"}), std::invalid_argument);
+}
+
+TEST_CASE("StringSwitch on many keys") {
+    constexpr size_t kKeys = 500;
+    RandomGenerator rnd(52);
+    std::set<std::string> unique;
+    while (unique.size() < kKeys) {
+        unique.insert(rnd.GenString(rnd.GenInt(1, 8), 'a', 'e'));
+    }
+    std::vector<std::string> keys(unique.begin(), unique.end());
+
+    StringView views[kKeys];
+    for (size_t i = 0; i < kKeys; ++i) {
+        views[i] = keys[i];
+    }
+    auto table = std::make_unique<StringSwitch<kKeys>>(views);
+    for (size_t i = 0; i < kKeys; ++i) {
+        REQUIRE(table->Find(keys[i]) == i);
+    }
+    for (int iter = 0; iter < 10000; ++iter) {
+        auto probe = rnd.GenString(rnd.GenInt(0, 9), 'a', 'f');
+        auto it = std::lower_bound(keys.begin(), keys.end(), probe);
+        size_t expected = it != keys.end() && *it == probe ? it - keys.begin()
+                                                           : StringSwitch<kKeys>::kNotFound;
+        REQUIRE(table->Find(probe) == expected);
+    }
+}
+
+namespace {
+
+template <class Range>
+std::vector<std::string> Tokens(const Range& range) {
+    std::vector<std::string> tokens;
+    for (StringView token : range) {
+        tokens.emplace_back(token.Data(), token.Size());
+    }
+    return tokens;
+}
+
+std::vector<std::string> NaiveSplit(const std::string& text, const std::string& delim) {
+    std::vector<std::string> tokens;
+    size_t start = 0;
+    while (true) {
+        size_t found = text.find(delim, start);
+        if (found == std::string::npos) {
+            tokens.push_back(text.substr(start));
+            return tokens;
+        }
+        tokens.push_back(text.substr(start, found - start));
+        start = found + delim.size();
+    }
+}
+
+constexpr size_t CountTokens(StringView text, char delim) {
+    size_t count = 0;
+    for (StringView token : Split(text, delim)) {
+        count += token.Size() > 0 ? 1 : 0;
+    }
+    return count;
+}
+
+}  // namespace
+
+TEST_CASE("Split") {
+    using V = std::vector<std::string>;
+    REQUIRE(Tokens(Split("a,b,c", ',')) == V{"a", "b", "c"});
+    REQUIRE(Tokens(Split("a,,b,", ',')) == V{"a", "", "b", ""});
+    REQUIRE(Tokens(Split("", ',')) == V{""});
+    REQUIRE(Tokens(Split(",", ',')) == V{"", ""});
+    REQUIRE(Tokens(Split("abc", ',')) == V{"abc"});
+
+    REQUIRE(Tokens(Split("a::b:c::", "::")) == V{"a", "b:c", ""});
+    REQUIRE(Tokens(Split("aaaa", "aa")) == V{"", "", ""});
+    REQUIRE(Tokens(Split("abc", "")) == V{"abc"});
+
+    REQUIRE(Tokens(SplitAnyOf("a b\tc\n\nd", " \t\n")) == V{"a", "b", "c", "", "d"});
+    REQUIRE(Tokens(SplitAnyOf("abc", "")) == V{"abc"});
+
+    // токены указывают внутрь исходной строки
+    std::string text = "key=value";
+    auto range = Split(text, '=');
+    auto it = range.begin();
+    REQUIRE(it->Data() == text.data());
+    ++it;
+    REQUIRE(it->Data() == text.data() + 4);
+    REQUIRE(++it == range.end());
+
+    static_assert(std::ranges::forward_range<SplitRange<CharDelimiter>>);
+    static_assert(CountTokens("usr/local//bin/", '/') == 3);
+}
+
+TEST_CASE("Split matches naive") {
+    RandomGenerator rnd(38);
+    for (int iter = 0; iter < 2000; ++iter) {
+        auto text = rnd.GenString(rnd.GenInt(0, 300), 'a', 'c');
+        auto delim = rnd.GenString(rnd.GenInt(1, 3), 'a', 'c');
+        REQUIRE(Tokens(Split(text, StringView(delim))) == NaiveSplit(text, delim));
+        REQUIRE(Tokens(Split(text, delim[0])) == NaiveSplit(text, delim.substr(0, 1)));
+    }
+}
+
+TEST_CASE("Split does not allocate") {
+    std::string text;
+    for (int i = 0; i < 100000; ++i) {
+        text += "token" + std::to_string(i) + (i % 7 == 0 ? ";" : ",");
+    }
+    size_t by_char = 0;
+    size_t by_string = 0;
+    size_t by_any = 0;
+    EXPECT_ZERO_ALLOCATIONS({
+        for (StringView token : Split(text, ',')) {
+            by_char += token.Size() > 0;
+        }
+        for (StringView token : Split(text, "n1")) {
+            by_string += token.Size() > 0;
+        }
+        for (StringView token : SplitAnyOf(text, ",;")) {
+            by_any += token.Size() > 0;
+        }
+    });
+    REQUIRE(by_any == 100000);
+    REQUIRE(by_char == static_cast<size_t>(std::count(text.begin(), text.end(), ',')));
+    REQUIRE(by_string == NaiveSplit(text, "n1").size());
+}
+
+TEST_CASE("Interner") {
+    StringInterner pool(64);
+    auto foo = pool.Intern("foo");
+    auto bar = pool.Intern("bar");
+    auto empty = pool.Intern("");
+    REQUIRE(foo.id == 0);
+    REQUIRE(bar.id == 1);
+    REQUIRE(empty.id == 2);
+    REQUIRE(foo.view == "foo");
+    REQUIRE(empty.view.Empty());
+
+    std::string copy = "foo";
+    auto again = pool.Intern(copy);
+    REQUIRE(again == foo);
+    REQUIRE(again.view.Data() == foo.view.Data());
+    REQUIRE(pool.Size() == 3);
+    REQUIRE(pool.Find("bar") == 1);
+    REQUIRE(pool.Find("baz") == StringInterner::kNotFound);
+    REQUIRE(pool.Lookup(1) == "bar");
+
+    // строка длиннее куска арены получает свой кусок
+    std::string long_string(1000, 'x');
+    REQUIRE(pool.Intern(long_string).view == StringView(long_string));
+
+    auto stats = pool.Stats();
+    REQUIRE(stats.unique_strings == 4);
+    REQUIRE(stats.intern_calls == 5);
+    REQUIRE(stats.requested_bytes == 1009);
+    REQUIRE(stats.stored_bytes == 1006);
+}
+
+TEST_CASE("Interner keeps views stable") {
+    StringInterner pool(4096);
+    std::vector<InternedString> first;
+    std::vector<std::string> keys;
+    for (int i = 0; i < 100000; ++i) {
+        keys.push_back("identifier_" + std::to_string(i));
+        first.push_back(pool.Intern(keys.back()));
+    }
+    for (int repeat = 0; repeat < 3; ++repeat) {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            auto interned = pool.Intern(keys[i]);
+            REQUIRE(interned.id == i);
+            REQUIRE(interned.view.Data() == first[i].view.Data());
+            REQUIRE(pool.Lookup(static_cast<uint32_t>(i)) == StringView(keys[i]));
+        }
+    }
+
+    auto stats = pool.Stats();
+    REQUIRE(stats.unique_strings == keys.size());
+    REQUIRE(stats.intern_calls == 4 * keys.size());
+    REQUIRE(stats.SavedBytes() > 0);
+}
+
+TEST_CASE("Interner concurrent readers") {
+    constexpr int kStrings = 20000;
+    StringInterner pool(1024);
+    std::atomic<bool> done = false;
+
+    // читатели ищут строки, пока писатель их добавляет
+    std::vector<std::thread> readers;
+    std::atomic<size_t> mismatches = 0;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&, t] {
+            size_t i = t;
+            while (!done.load()) {
+                std::string key = "s" + std::to_string(i++ % kStrings);
+                uint32_t id = pool.Find(key);
+                if (id != StringInterner::kNotFound && !(pool.Lookup(id) == StringView(key))) {
+                    ++mismatches;
+                }
+                auto interned = pool.Intern("s" + std::to_string(i % 100));
+                if (!(pool.Lookup(interned.id) == interned.view)) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (int i = 0; i < kStrings; ++i) {
+        pool.Intern("s" + std::to_string(i));
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    REQUIRE(mismatches == 0);
+    REQUIRE(pool.Size() == kStrings);
+    for (int i = 0; i < kStrings; ++i) {
+        std::string key = "s" + std::to_string(i);
+        REQUIRE(pool.Lookup(pool.Find(key)) == StringView(key));
+    }
+}
+
+TEST_CASE("Hash") {
+    static_assert("abc"_sv.Hash() == StringView("abc").Hash());
+    static_assert("abc"_sv.Hash() != "abc"_sv.Hash(1));
+
+    // хеш на этапе компиляции совпадает с рантаймовым на всех ветках длины
+    constexpr StringView kText = "The quick brown fox jumps over the lazy dog, twice over the lazy dog";
+    constexpr uint64_t kHashes[] = {kText.Substr(0, 0).Hash(),  kText.Substr(0, 3).Hash(),
+                                    kText.Substr(0, 7).Hash(),  kText.Substr(0, 16).Hash(),
+                                    kText.Substr(0, 40).Hash(), kText.Hash()};
+    std::string text(kText.Data(), kText.Size());
+    size_t lengths[] = {0, 3, 7, 16, 40, text.size()};
+    for (size_t i = 0; i < std::size(lengths); ++i) {
+        REQUIRE(StringView(text, 0, lengths[i]).Hash() == kHashes[i]);
+    }
+
+    // все длины и сдвиги: разные строки почти не дают одинаковых хешей
+    RandomGenerator rnd(40);
+    std::string buffer = rnd.GenString(300);
+    std::unordered_set<uint64_t> hashes;
+    size_t count = 0;
+    for (size_t len = 0; len <= 200; ++len) {
+        for (size_t shift = 0; shift < 8; ++shift) {
+            auto str = buffer.substr(shift, len);
+            REQUIRE(StringView(str).Hash() == StringView(buffer, shift, len).Hash());
+            hashes.insert(StringView(str).Hash());
+            ++count;
+        }
+    }
+    REQUIRE(hashes.size() == count - 7);  // восемь пустых строк совпадают
+}
+
+TEST_CASE("Equality and ordering") {
+    RandomGenerator rnd(4040);
+    for (int iter = 0; iter < 5000; ++iter) {
+        size_t len = rnd.GenInt(0, 100);
+        auto lhs = rnd.GenString(len, 'a', 'b');
+        auto rhs = lhs;
+        if (!rhs.empty() && rnd.GenInt(0, 1)) {
+            rhs[rnd.GenInt<size_t>(0, rhs.size() - 1)] = rnd.GenInt(0, 1) ? '\xff' : 'a';
+        }
+        if (rnd.GenInt(0, 3) == 0) {
+            rhs.resize(rnd.GenInt<size_t>(0, rhs.size()));
+        }
+        StringView a(lhs);
+        StringView b(rhs);
+        REQUIRE((a == b) == (lhs == rhs));
+        REQUIRE((a < b) == (lhs < rhs));
+        REQUIRE((a > b) == (lhs > rhs));
+        int expected = lhs.compare(rhs);
+        REQUIRE((a.Compare(b) < 0) == (expected < 0));
+        REQUIRE((a.Compare(b) == 0) == (expected == 0));
+    }
+}
+
+TEST_CASE("StringView keys in containers") {
+    std::unordered_map<StringView, int> by_view;
+    std::string first = "first";
+    by_view[first] = 1;
+    by_view["second"] = 2;
+    REQUIRE(by_view.at("first") == 1);
+    REQUIRE(by_view.count("third") == 0);
+
+    std::unordered_map<std::string, int, StringViewHash, std::equal_to<>> by_string;
+    by_string["key"] = 7;
+    REQUIRE(by_string.find(StringView("key"))->second == 7);
+    REQUIRE(by_string.find(StringView("other")) == by_string.end());
+
+    std::map<StringView, int> ordered = {{"b", 2}, {"a", 1}, {"ab", 3}};
+    std::vector<std::string> keys;
+    for (const auto& [key, value] : ordered) {
+        keys.emplace_back(key.Data(), key.Size());
+    }
+    REQUIRE(keys == std::vector<std::string>{"a", "ab", "b"});
+}
+
+namespace {
+
+std::string EncodeUtf8(char32_t c) {
+    std::string out;
+    if (c < 0x80) {
+        out += static_cast<char>(c);
+    } else if (c < 0x800) {
+        out += static_cast<char>(0xc0 | (c >> 6));
+        out += static_cast<char>(0x80 | (c & 0x3f));
+    } else if (c < 0x10000) {
+        out += static_cast<char>(0xe0 | (c >> 12));
+        out += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+        out += static_cast<char>(0x80 | (c & 0x3f));
+    } else {
+        out += static_cast<char>(0xf0 | (c >> 18));
+        out += static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+        out += static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+        out += static_cast<char>(0x80 | (c & 0x3f));
+    }
+    return out;
+}
+
+std::vector<char32_t> Decoded(StringView text) {
+    std::vector<char32_t> result;
+    for (char32_t c : CodePoints(text)) {
+        result.push_back(c);
+    }
+    return result;
+}
+
+}  // namespace
+
+TEST_CASE("Utf8 validation") {
+    REQUIRE(IsValidUtf8(""));
+    REQUIRE(IsValidUtf8("plain ascii"));
+    REQUIRE(IsValidUtf8("\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82"));  // Привет
+    REQUIRE(IsValidUtf8("\xe4\xbd\xa0\xe5\xa5\xbd\xf0\x9f\x98\x80"));
+    REQUIRE(IsValidUtf8("\xf4\x8f\xbf\xbf"));  // U+10FFFF
+
+    const char* invalid[] = {
+        "\x80",              // одинокое продолжение
+        "\xc3",              // оборванная последовательность
+        "\xc3\x28",          // нет продолжения
+        "\xc0\xaf",          // overlong '/'
+        "\xe0\x80\xaf",      // overlong
+        "\xed\xa0\x80",      // суррогат U+D800
+        "\xf4\x90\x80\x80",  // больше U+10FFFF
+        "\xf5\x80\x80\x80",  // недопустимый ведущий байт
+        "\xe2\x82",          // оборвано на конце
+        "\xff",
+    };
+    for (const char* str : invalid) {
+        REQUIRE(!IsValidUtf8(str));
+        REQUIRE(!utf8::IsValidScalar(str, std::strlen(str)));
+        // ошибка на каждой позиции относительно 32-байтных блоков
+        for (size_t shift = 0; shift < 70; ++shift) {
+            std::string text = std::string(shift, 'a') + str + std::string(70 - shift, 'b');
+            REQUIRE(!IsValidUtf8(text));
+            REQUIRE(!IsValidUtf8(std::string(shift, 'a') + str));
+        }
+    }
+}
+
+TEST_CASE("Utf8 decoding of every code point") {
+    std::string text;
+    size_t expected = 0;
+    for (char32_t c = 0; c <= 0x10ffff; ++c) {
+        auto encoded = EncodeUtf8(c);
+        auto decoded = utf8::Decode(encoded.data(), encoded.size());
+        bool surrogate = c >= 0xd800 && c <= 0xdfff;
+        REQUIRE(decoded.valid == !surrogate);
+        if (!surrogate) {
+            REQUIRE(decoded.code_point == c);
+            REQUIRE(decoded.length == encoded.size());
+            text += encoded;
+            ++expected;
+        }
+    }
+    REQUIRE(IsValidUtf8(text));
+    REQUIRE(CountCodePoints(text) == expected);
+}
+
+TEST_CASE("Utf8 matches scalar") {
+    RandomGenerator rnd(41);
+    for (int iter = 0; iter < 5000; ++iter) {
+        std::string text;
+        size_t count = rnd.GenInt(0, 40);
+        for (size_t i = 0; i < count; ++i) {
+            switch (rnd.GenInt(0, 3)) {
+                case 0:
+                    text += EncodeUtf8(rnd.GenInt<char32_t>(0, 0x7f));
+                    break;
+                case 1:
+                    text += EncodeUtf8(rnd.GenInt<char32_t>(0x80, 0x7ff));
+                    break;
+                case 2:
+                    text += EncodeUtf8(rnd.GenInt<char32_t>(0x800, 0xffff));
+                    break;
+                default:
+                    text += EncodeUtf8(rnd.GenInt<char32_t>(0x10000, 0x10ffff));
+            }
+        }
+        // портим пару байт или обрезаем
+        int mutations = rnd.GenInt(0, 2);
+        for (int m = 0; m < mutations && !text.empty(); ++m) {
+            text[rnd.GenInt<size_t>(0, text.size() - 1)] = static_cast<char>(rnd.GenInt(0, 255));
+        }
+        if (!text.empty() && rnd.GenInt(0, 3) == 0) {
+            text.resize(rnd.GenInt<size_t>(0, text.size() - 1));
+        }
+
+        bool valid = utf8::IsValidScalar(text.data(), text.size());
+        REQUIRE(IsValidUtf8(text) == valid);
+        if (valid) {
+            REQUIRE(CountCodePoints(text) == Decoded(text).size());
+        }
+    }
+}
+
+TEST_CASE("Code point iterator") {
+    StringView text = "a\xd0\xaf\xe2\x82\xac\xf0\x9f\x98\x80";  // a Я € 😀
+    REQUIRE(Decoded(text) == std::vector<char32_t>{U'a', U'\u042f', U'\u20ac', U'\U0001f600'});
+    REQUIRE(CountCodePoints(text) == 4);
+
+    std::vector<size_t> offsets;
+    CodePoints range(text);
+    for (auto it = range.begin(); it != range.end(); ++it) {
+        offsets.push_back(it.Offset());
+    }
+    REQUIRE(offsets == std::vector<size_t>{0, 1, 3, 6});
+
+    // по одной замене на максимальную корректную часть
+    REQUIRE(Decoded("\xe2\x82x\x80\xf0\x9f") ==
+            std::vector<char32_t>{0xfffd, U'x', 0xfffd, 0xfffd});
+}
+
+TEST_CASE("RopeView") {
+    std::string body = "world";
+    RopeView rope = {"hello", ", ", "", body, "!"};
+    REQUIRE(rope.Size() == 13);
+    REQUIRE(rope.SegmentCount() == 4);  // пустой кусок пропущен
+    REQUIRE(rope.ToString() == "hello, world!");
+    REQUIRE(rope[0] == 'h');
+    REQUIRE(rope[5] == ',');
+    REQUIRE(rope[7] == 'w');
+    REQUIRE(rope[12] == '!');
+    REQUIRE(rope.SegmentAt(2).Data() == body.data());
+
+    REQUIRE(std::string(rope.begin(), rope.end()) == "hello, world!");
+
+    REQUIRE(rope.Find("lo, w") == 3);
+    REQUIRE(rope.Find("d!") == 11);
+    REQUIRE(rope.Find("o") == 4);
+    REQUIRE(rope.Find("o", 5) == 8);
+    REQUIRE(rope.Find('w') == 7);
+    REQUIRE(rope.Find("hello, world!!") == RopeView::npos);
+    REQUIRE(rope.Find("") == 0);
+
+    char buffer[13];
+    REQUIRE(rope.Flatten(buffer, sizeof(buffer)) == 13);
+    REQUIRE(std::string(buffer, 13) == "hello, world!");
+    REQUIRE_THROWS_AS(rope.Flatten(buffer, 12), std::length_error);
+
+    RopeView copy = rope;
+    RopeView moved = std::move(copy);
+    REQUIRE(moved.ToString() == "hello, world!");
+}
+
+TEST_CASE("RopeView matches std::string") {
+    RandomGenerator rnd(42);
+    for (int iter = 0; iter < 500; ++iter) {
+        auto text = rnd.GenString(rnd.GenInt(0, 300), 'a', 'c');
+        // режем на куски случайной длины, в том числе больше kInlineSegments
+        RopeView rope;
+        for (size_t pos = 0; pos < text.size();) {
+            size_t len = rnd.GenInt<size_t>(0, 6);
+            rope.Append(StringView(text.data() + pos, std::min(len, text.size() - pos)));
+            pos += len;
+        }
+        REQUIRE(rope.Size() == text.size());
+        REQUIRE(rope.ToString() == text);
+        for (size_t i = 0; i < text.size(); ++i) {
+            REQUIRE(rope[i] == text[i]);
+        }
+        for (int probe = 0; probe < 20; ++probe) {
+            auto needle = rnd.GenString(rnd.GenInt(1, 8), 'a', 'c');
+            size_t pos = rnd.GenInt<size_t>(0, text.size());
+            REQUIRE(rope.Find(needle, pos) == text.find(needle, pos));
+            REQUIRE(rope.Find(needle[0], pos) == text.find(needle[0], pos));
+        }
+    }
+}
+
+TEST_CASE("RopeView writev") {
+    std::vector<std::string> parts;
+    RopeView rope;
+    std::string expected;
+    for (int i = 0; i < 3000; ++i) {
+        parts.push_back("part" + std::to_string(i) + ";");
+    }
+    for (const auto& part : parts) {
+        rope.Append(part);
+        expected += part;
+    }
+
+    // кусков больше, чем уходит в один writev
+    std::FILE* file = std::tmpfile();
+    REQUIRE(file != nullptr);
+    int fd = fileno(file);
+    rope.WriteTo(fd);
+    REQUIRE(::lseek(fd, 0, SEEK_SET) == 0);
+    std::string actual(expected.size() + 1, '\0');
+    REQUIRE(::read(fd, actual.data(), actual.size()) == static_cast<ssize_t>(expected.size()));
+    actual.resize(expected.size());
+    REQUIRE(actual == expected);
+    std::fclose(file);
+
+    REQUIRE_THROWS_AS(rope.WriteTo(-1), std::system_error);
+}
@@ -0,0 +1,329 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+#include "string_search.h"
+#include "string_view.h"
+
+// Проверка и разбор UTF-8 поверх StringView.
+//
+// IsValidUtf8 на AVX2 проверяет по 32 байта за шаг алгоритмом Кейзера и Лемира
+// (три табличных поиска по полубайтам соседних байт плюс проверка длины
+// многобайтных последовательностей), без AVX2 — скалярно с быстрым пропуском
+// ASCII по 8 байт. Корректность — по таблице 3-7 стандарта Unicode: запрещены
+// overlong-формы, суррогаты и всё, что больше U+10FFFF.
+namespace utf8 {
+
+inline constexpr char32_t kReplacement = 0xfffd;
+
+struct Decoded {
+    char32_t code_point;
+    // сколько байт занимает символ; для ошибки — длина максимальной
+    // корректной части последовательности, минимум 1
+    size_t length;
+    bool valid;
+};
+
+// Разбирает один символ в начале [data, data + size), size > 0
+constexpr Decoded Decode(const char* data, size_t size) {
+    auto byte = [data](size_t i) { return static_cast<unsigned char>(data[i]); };
+    unsigned char lead = byte(0);
+    if (lead < 0x80) {
+        return {lead, 1, true};
+    }
+
+    size_t length = 0;
+    char32_t code_point = 0;
+    // допустимый диапазон второго байта зависит от первого
+    unsigned char low = 0x80;
+    unsigned char high = 0xbf;
+    if (lead >= 0xc2 && lead <= 0xdf) {
+        length = 2;
+        code_point = lead & 0x1f;
+    } else if (lead >= 0xe0 && lead <= 0xef) {
+        length = 3;
+        code_point = lead & 0x0f;
+        low = lead == 0xe0 ? 0xa0 : 0x80;
+        high = lead == 0xed ? 0x9f : 0xbf;
+    } else if (lead >= 0xf0 && lead <= 0xf4) {
+        length = 4;
+        code_point = lead & 0x07;
+        low = lead == 0xf0 ? 0x90 : 0x80;
+        high = lead == 0xf4 ? 0x8f : 0xbf;
+    } else {
+        return {kReplacement, 1, false};
+    }
+
+    for (size_t i = 1; i < length; ++i) {
+        if (i >= size || byte(i) < low || byte(i) > high) {
+            return {kReplacement, i, false};
+        }
+        code_point = (code_point << 6) | (byte(i) & 0x3f);
+        low = 0x80;
+        high = 0xbf;
+    }
+    return {code_point, length, true};
+}
+
+// Скалярная проверка; ASCII пропускается словами по 8 байт
+inline bool IsValidScalar(const char* data, size_t size) {
+    size_t i = 0;
+    while (i < size) {
+        if (i + 8 <= size) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            if ((word & 0x8080808080808080ull) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+        Decoded decoded = Decode(data + i, size - i);
+        if (!decoded.valid) {
+            return false;
+        }
+        i += decoded.length;
+    }
+    return true;
+}
+
+#if defined(__AVX2__)
+
+// Векторный проверяльщик: состояние между блоками — предыдущий блок,
+// накопленные ошибки и признак незаконченной последовательности в его конце
+class Avx2Validator {
+public:
+    void Feed(__m256i input) {
+        // блок из одного ASCII корректен сам по себе; ошибка — только если
+        // предыдущий блок оборвался посреди символа
+        if (_mm256_movemask_epi8(input) == 0) {
+            error_ = _mm256_or_si256(error_, prev_incomplete_);
+        } else {
+            __m256i prev1 = Prev<1>(input);
+            __m256i special = CheckSpecialCases(input, prev1);
+            error_ = _mm256_or_si256(error_, CheckMultibyteLengths(input, special));
+            prev_incomplete_ = IsIncomplete(input);
+        }
+        prev_input_ = input;
+    }
+
+    bool Finish() {
+        error_ = _mm256_or_si256(error_, prev_incomplete_);
+        return _mm256_testz_si256(error_, error_) != 0;
+    }
+
+private:
+    __m256i error_ = _mm256_setzero_si256();
+    __m256i prev_input_ = _mm256_setzero_si256();
+    __m256i prev_incomplete_ = _mm256_setzero_si256();
+
+    // input, сдвинутый на N байт назад с подстановкой хвоста prev_input_
+    template <int N>
+    __m256i Prev(__m256i input) const {
+        return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev_input_, input, 0x21),
+                                  16 - N);
+    }
+
+    static __m256i HighNibble(__m256i v) {
+        return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0f));
+    }
+
+    static __m256i Lookup(__m256i index, __m256i table) {
+        return _mm256_shuffle_epi8(table, index);
+    }
+
+    static __m256i Table(uint8_t t0, uint8_t t1, uint8_t t2, uint8_t t3, uint8_t t4, uint8_t t5,
+                         uint8_t t6, uint8_t t7, uint8_t t8, uint8_t t9, uint8_t t10, uint8_t t11,
+                         uint8_t t12, uint8_t t13, uint8_t t14, uint8_t t15) {
+        return _mm256_setr_epi8(t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13, t14,
+                                t15, t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, t12, t13,
+                                t14, t15);
+    }
+
+    // Ошибки, видимые по паре соседних байт. Каждый бит — свой класс ошибок;
+    // ошибка есть, если бит выставлен во всех трёх таблицах сразу
+    static __m256i CheckSpecialCases(__m256i input, __m256i prev1) {
+        constexpr uint8_t kTooShort = 1 << 0;   // 11______ 0_______ и 11______ 11______
+        constexpr uint8_t kTooLong = 1 << 1;    // 0_______ 10______
+        constexpr uint8_t kOverlong3 = 1 << 2;  // 11100000 100_____
+        constexpr uint8_t kTooLarge = 1 << 3;   // 11110100 1001____ и старше
+        constexpr uint8_t kSurrogate = 1 << 4;  // 11101101 101_____
+        constexpr uint8_t kOverlong2 = 1 << 5;  // 1100000_ 10______
+        constexpr uint8_t kTooLarge1000 = 1 << 6;  // 11110101 1000____ и старше
+        constexpr uint8_t kOverlong4 = 1 << 6;     // 11110000 1000____
+        constexpr uint8_t kTwoConts = 1 << 7;      // 10______ 10______
+        constexpr uint8_t kCarry = kTooShort | kTooLong | kTwoConts;
+        constexpr uint8_t kLarge = kCarry | kTooLarge | kTooLarge1000;
+
+        __m256i byte1_high = Lookup(
+            HighNibble(prev1),
+            Table(kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+                  kTwoConts, kTwoConts, kTwoConts, kTwoConts, kTooShort | kOverlong2, kTooShort,
+                  kTooShort | kOverlong3 | kSurrogate,
+                  kTooShort | kTooLarge | kTooLarge1000 | kOverlong4));
+        __m256i byte1_low = Lookup(
+            _mm256_and_si256(prev1, _mm256_set1_epi8(0x0f)),
+            Table(kCarry | kOverlong3 | kOverlong2 | kOverlong4, kCarry | kOverlong2, kCarry,
+                  kCarry, kCarry | kTooLarge, kLarge, kLarge, kLarge, kLarge, kLarge, kLarge,
+                  kLarge, kLarge, kLarge | kSurrogate, kLarge, kLarge));
+        __m256i byte2_high = Lookup(
+            HighNibble(input),
+            Table(kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+                  kTooShort,
+                  kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+                  kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+                  kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge,
+                  kTooLong | kOverlong2 | kTwoConts | kSurrogate | kTooLarge, kTooShort,
+                  kTooShort, kTooShort, kTooShort));
+        return _mm256_and_si256(_mm256_and_si256(byte1_high, byte1_low), byte2_high);
+    }
+
+    // Третий и четвёртый байты 3- и 4-байтных символов должны быть продолжениями.
+    // Таблицы отмечают пару «продолжение после продолжения» как ошибку, а здесь
+    // она снимается xor-ом там, где продолжение и требовалось
+    __m256i CheckMultibyteLengths(__m256i input, __m256i special) const {
+        __m256i prev2 = Prev<2>(input);
+        __m256i prev3 = Prev<3>(input);
+        // только 111_____ и 1111____ дадут старший бит после вычитания
+        __m256i is_third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(0xe0 - 0x80));
+        __m256i is_fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xf0 - 0x80));
+        __m256i must23 = _mm256_and_si256(_mm256_or_si256(is_third, is_fourth),
+                                          _mm256_set1_epi8(static_cast<char>(0x80)));
+        return _mm256_xor_si256(must23, special);
+    }
+
+    // Последние три байта блока начинают символ, не помещающийся в блок
+    static __m256i IsIncomplete(__m256i input) {
+        __m256i max = _mm256_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xf0 - 1),
+            static_cast<char>(0xe0 - 1), static_cast<char>(0xc0 - 1));
+        return _mm256_subs_epu8(input, max);
+    }
+};
+
+inline bool IsValidAvx2(const char* data, size_t size) {
+    Avx2Validator validator;
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        validator.Feed(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+    }
+    if (i < size) {
+        // хвост дополняется нулями: это ASCII, он не меняет ответ
+        alignas(32) char tail[32] = {};
+        std::memcpy(tail, data + i, size - i);
+        validator.Feed(_mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+    }
+    return validator.Finish();
+}
+
+#endif
+
+}  // namespace utf8
+
+inline bool IsValidUtf8(StringView str) {
+#if defined(__AVX2__)
+    return utf8::IsValidAvx2(str.Data(), str.Size());
+#else
+    return utf8::IsValidScalar(str.Data(), str.Size());
+#endif
+}
+
+// Число символов в корректной UTF-8 строке — это число байт, не являющихся
+// продолжениями (10______). Для некорректной строки результат — та же оценка
+inline size_t CountCodePoints(StringView str) {
+    const char* data = str.Data();
+    size_t size = str.Size();
+    size_t count = 0;
+    size_t i = 0;
+#if STRING_SEARCH_HAS_SIMD
+    using string_search::Block;
+    // продолжения — это байты 0x80..0xbf, то есть не больше -65 как знаковые
+    const Block threshold = Block::Splat(static_cast<char>(-65));
+    for (; i + Block::kSize <= size; i += Block::kSize) {
+        count += __builtin_popcount(Block::Load(data + i).Gt(threshold));
+    }
+#endif
+    for (; i < size; ++i) {
+        count += (static_cast<unsigned char>(data[i]) & 0xc0) != 0x80;
+    }
+    return count;
+}
+
+// Обход символов строки:
+//
+//     for (char32_t c : CodePoints(text)) { ... }
+//
+// Некорректные последовательности превращаются в U+FFFD, по одному на
+// максимальную корректную часть, как рекомендует стандарт Unicode
+class CodePoints {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = char32_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const char32_t*;
+        using reference = char32_t;
+
+        constexpr Iterator() = default;
+
+        constexpr char32_t operator*() const {
+            return current_.code_point;
+        }
+
+        // смещение текущего символа в исходной строке в байтах
+        constexpr size_t Offset() const {
+            return pos_;
+        }
+
+        constexpr Iterator& operator++() {
+            pos_ += current_.length;
+            Load();
+            return *this;
+        }
+
+        constexpr Iterator operator++(int) {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        constexpr bool operator==(const Iterator& other) const {
+            return pos_ == other.pos_;
+        }
+
+    private:
+        friend class CodePoints;
+
+        StringView text_;
+        size_t pos_ = 0;
+        utf8::Decoded current_{};
+
+        constexpr Iterator(StringView text, size_t pos) : text_(text), pos_(pos) {
+            Load();
+        }
+
+        constexpr void Load() {
+            if (pos_ < text_.Size()) {
+                current_ = utf8::Decode(text_.Data() + pos_, text_.Size() - pos_);
+            }
+        }
+    };
+
+    constexpr explicit CodePoints(StringView text) : text_(text) {
+    }
+
+    constexpr Iterator begin() const {
+        return Iterator(text_, 0);
+    }
+
+    constexpr Iterator end() const {
+        return Iterator(text_, text_.Size());
+    }
+
+private:
+    StringView text_;
+};
@@ -0,0 +1,116 @@
+// Память и скорость обхода: List<T> против SList<T> и XorList<T>.
+// Запуск: bench_compact_list [size] > result.json
+// Узлы лежат в одном массиве; "shuffled" связывает их в случайном порядке,
+// чтобы обход упирался в промахи кэша, "sequential" — в порядке адресов.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "compact_list.h"
+#include "intrusive_list.h"
+
+namespace {
+
+struct ListNode : public BasicListHook<NormalLink> {
+    int value = 0;
+};
+
+struct SListNode : public SListHook<> {
+    int value = 0;
+};
+
+struct XorListNode : public XorListHook<> {
+    int value = 0;
+};
+
+// Каждый замер меняет список, поэтому прогон один
+template <class Body>
+double NsPerOp(size_t ops, Body body) {
+    return bench::BestNsPerOp(ops, body, 1);
+}
+
+template <class Node, class L>
+void RunAll(const char* impl, const std::vector<size_t>& order, const char* order_name,
+            bench::Report* report) {
+    const size_t n = order.size();
+    std::unique_ptr<Node[]> nodes(new Node[n]);
+    for (size_t i = 0; i < n; ++i) {
+        nodes[i].value = static_cast<int>(i);
+    }
+
+    auto add = [&](std::string op, double value, const char* unit) {
+        report->Add().Set("op", op).Set("impl", impl).Set("size", n).Set(unit, value);
+        std::fprintf(stderr, "%-22s %-8s %10zu %8.2f %s\n", op.c_str(), impl, n, value, unit);
+    };
+
+    L list;
+    add(std::string("push_back_") + order_name, NsPerOp(n, [&] {
+            for (size_t idx : order) {
+                list.PushBack(&nodes[idx]);
+            }
+        }),
+        "ns_per_op");
+
+    add(std::string("iterate_") + order_name, NsPerOp(n, [&] {
+            int64_t sum = 0;
+            for (auto& node : list) {
+                sum += node.value;
+            }
+            bench::Consume(sum);
+        }),
+        "ns_per_op");
+
+    add(std::string("pop_front_") + order_name, NsPerOp(n, [&] {
+            while (!list.IsEmpty()) {
+                list.PopFront();
+            }
+        }),
+        "ns_per_op");
+}
+
+template <class Node, class L>
+void RunType(const char* impl, const std::vector<size_t>& sequential,
+             const std::vector<size_t>& shuffled, bench::Report* report) {
+    report->Add()
+        .Set("op", "node_bytes")
+        .Set("impl", impl)
+        .Set("size", sequential.size())
+        .Set("bytes", sizeof(Node));
+    report->Add()
+        .Set("op", "total_bytes")
+        .Set("impl", impl)
+        .Set("size", sequential.size())
+        .Set("bytes", sizeof(Node) * sequential.size());
+    RunAll<Node, L>(impl, sequential, "sequential", report);
+    RunAll<Node, L>(impl, shuffled, "shuffled", report);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t n = 10'000'000;
+    if (argc > 1) {
+        n = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    std::vector<size_t> sequential(n);
+    std::iota(sequential.begin(), sequential.end(), 0);
+    std::vector<size_t> shuffled = sequential;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937_64(20250901));
+
+    bench::Report report("compact_list");
+    RunType<ListNode, List<ListNode>>("List", sequential, shuffled, &report);
+    RunType<SListNode, SList<SListNode>>("SList", sequential, shuffled, &report);
+    RunType<XorListNode, XorList<XorListNode>>("XorList", sequential, shuffled, &report);
+
+    report.Print();
+    return 0;
+}
@@ -0,0 +1,122 @@
+// Бенчмарк передачи объектов между потоками: MpscQueue против List<T> под мьютексом.
+// Запуск: bench_mpsc_queue [items_per_producer] > result.json
+// Потребитель в обоих случаях забирает элементы пачками: MpscQueue::Drain
+// или перенос всего List<T> под локом с последующим разбором без лока.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "intrusive_list.h"
+#include "mpsc_queue.h"
+
+namespace {
+
+struct Message : public ListHook, public MpscQueueHook<> {
+    int64_t payload = 0;
+};
+
+template <class Produce, class Consume>
+double Run(size_t producers, size_t per_producer, Produce produce, Consume consume) {
+    std::vector<std::unique_ptr<Message[]>> messages;
+    for (size_t p = 0; p < producers; ++p) {
+        messages.emplace_back(new Message[per_producer]);
+        for (size_t i = 0; i < per_producer; ++i) {
+            messages[p][i].payload = static_cast<int64_t>(i);
+        }
+    }
+
+    const size_t total = producers * per_producer;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (size_t i = 0; i < per_producer; ++i) {
+                produce(&messages[p][i]);
+            }
+        });
+    }
+    int64_t sum = 0;
+    for (size_t received = 0; received < total;) {
+        received += consume(&sum);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    auto finish = std::chrono::steady_clock::now();
+
+    bench::Consume(sum);
+    return std::chrono::duration<double, std::nano>(finish - start).count() /
+           static_cast<double>(total);
+}
+
+double RunMpsc(size_t producers, size_t per_producer) {
+    MpscQueue<Message> queue;
+    return Run(
+        producers, per_producer, [&](Message* m) { queue.Push(m); },
+        [&](int64_t* sum) {
+            return queue.Drain([&](Message* m) { *sum += m->payload; });
+        });
+}
+
+double RunMutexList(size_t producers, size_t per_producer) {
+    std::mutex mutex;
+    List<Message> shared;
+    return Run(
+        producers, per_producer,
+        [&](Message* m) {
+            std::lock_guard<std::mutex> lock(mutex);
+            shared.PushBack(m);
+        },
+        [&](int64_t* sum) {
+            List<Message> batch;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                batch = std::move(shared);
+            }
+            size_t count = 0;
+            while (!batch.IsEmpty()) {
+                *sum += batch.Front().payload;
+                batch.PopFront();
+                ++count;
+            }
+            return count;
+        });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t per_producer = 1'000'000;
+    if (argc > 1) {
+        per_producer = std::strtoull(argv[1], nullptr, 10);
+    }
+    const size_t max_producers =
+        std::max<size_t>(1, std::thread::hardware_concurrency() > 1
+                                ? std::thread::hardware_concurrency() - 1
+                                : 1);
+
+    bench::Report report("mpsc_queue");
+    auto add = [&](const char* impl, size_t producers, double ns) {
+        report.Add()
+            .Set("op", "handoff")
+            .Set("impl", impl)
+            .Set("threads", producers)
+            .Set("size", per_producer)
+            .Set("ns_per_op", ns);
+        std::fprintf(stderr, "%-12s %3zu producers %8.2f ns/op\n", impl, producers, ns);
+    };
+    for (size_t producers = 1; producers <= max_producers; producers *= 2) {
+        add("MpscQueue", producers, RunMpsc(producers, per_producer));
+        add("mutex+List", producers, RunMutexList(producers, per_producer));
+    }
+    report.Print();
+    return 0;
+}
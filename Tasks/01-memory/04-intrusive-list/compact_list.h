@@ -0,0 +1,409 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+
+#include "intrusive_list.h"
+
+// Компактные варианты интрузивного списка: хук в один указатель вместо двух.
+// Узлы не отлинковываются сами и ничего не проверяют (как NormalLink),
+// поэтому объект нужно вынуть из списка до его уничтожения.
+
+// Узел односвязного списка
+template <class Tag = DefaultListTag>
+class SListHook {
+public:
+    SListHook() : next_(nullptr) {
+    }
+    SListHook(const SListHook&) = delete;
+    SListHook& operator=(const SListHook&) = delete;
+    SListHook(SListHook&&) = delete;
+    SListHook& operator=(SListHook&&) = delete;
+
+private:
+    SListHook* next_;
+
+    template <class T, class ListTag>
+    friend class SList;
+};
+
+// Односвязный список: PushBack/PushFront/PopFront за O(1), обход только вперёд
+template <typename T, typename Tag = DefaultListTag>
+class SList {
+    using Hook = SListHook<Tag>;
+
+public:
+    class Iterator {
+        using IteratorTag = std::forward_iterator_tag;
+
+    public:
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef T* pointer;
+        typedef T& reference;
+        typedef IteratorTag iterator_category;
+
+        Iterator(Hook* ptr) : ptr_(ptr) {
+        }
+
+        Iterator& operator++() {
+            ptr_ = ptr_->next_;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator tmp(*this);
+            ++(*this);
+            return tmp;
+        }
+
+        reference operator*() const {
+            return static_cast<T&>(*ptr_);
+        }
+        pointer operator->() const {
+            return &static_cast<T&>(*ptr_);
+        }
+
+        bool operator==(const Iterator& rhs) const {
+            return ptr_ == rhs.ptr_;
+        }
+        bool operator!=(const Iterator& rhs) const {
+            return !(*this == rhs);
+        }
+
+    private:
+        Hook* ptr_;
+    };
+
+    SList() : head_(nullptr), tail_(nullptr) {
+    }
+
+    SList(const SList&) = delete;
+    SList& operator=(const SList&) = delete;
+
+    SList(SList&& other) noexcept : head_(other.head_), tail_(other.tail_) {
+        other.head_ = other.tail_ = nullptr;
+    }
+
+    SList& operator=(SList&& other) noexcept {
+        if (this != &other) {
+            head_ = other.head_;
+            tail_ = other.tail_;
+            other.head_ = other.tail_ = nullptr;
+        }
+        return *this;
+    }
+
+    bool IsEmpty() const {
+        return head_ == nullptr;
+    }
+
+    size_t Size() const {
+        size_t size = 0;
+        for (auto* it = head_; it != nullptr; it = it->next_) {
+            ++size;
+        }
+        return size;
+    }
+
+    void Clear() {
+        head_ = tail_ = nullptr;
+    }
+
+    void PushBack(T* elem) {
+        Hook* node = static_cast<Hook*>(elem);
+        node->next_ = nullptr;
+        if (tail_ == nullptr) {
+            head_ = node;
+        } else {
+            tail_->next_ = node;
+        }
+        tail_ = node;
+    }
+    void PushFront(T* elem) {
+        Hook* node = static_cast<Hook*>(elem);
+        node->next_ = head_;
+        if (head_ == nullptr) {
+            tail_ = node;
+        }
+        head_ = node;
+    }
+
+    T& Front() {
+        if (IsEmpty()) {
+            throw std::runtime_error("List is empty");
+        }
+        return static_cast<T&>(*head_);
+    }
+    const T& Front() const {
+        if (IsEmpty()) {
+            throw std::runtime_error("List is empty");
+        }
+        return static_cast<const T&>(*head_);
+    }
+
+    T& Back() {
+        if (IsEmpty()) {
+            throw std::runtime_error("List is empty");
+        }
+        return static_cast<T&>(*tail_);
+    }
+    const T& Back() const {
+        if (IsEmpty()) {
+            throw std::runtime_error("List is empty");
+        }
+        return static_cast<const T&>(*tail_);
+    }
+
+    void PopFront() {
+        if (IsEmpty()) {
+            throw std::runtime_error("List is empty");
+        }
+        head_ = head_->next_;
+        if (head_ == nullptr) {
+            tail_ = nullptr;
+        }
+    }
+
+    Iterator Begin() {
+        return Iterator(head_);
+    }
+    Iterator End() {
+        return Iterator(nullptr);
+    }
+
+private:
+    Hook* head_;
+    Hook* tail_;
+};
+
+// Узел XOR-списка: хранит prev ^ next в одном слове
+template <class Tag = DefaultListTag>
+class XorListHook {
+public:
+    XorListHook() : link_(0) {
+    }
+    XorListHook(const XorListHook&) = delete;
+    XorListHook& operator=(const XorListHook&) = delete;
+    XorListHook(XorListHook&&) = delete;
+    XorListHook& operator=(XorListHook&&) = delete;
+
+private:
+    uintptr_t link_;
+
+    template <class T, class ListTag>
+    friend class XorList;
+
+    // Зная одного соседа, получаем другого
+    XorListHook* Other(const XorListHook* neighbour) const {
+        return reinterpret_cast<XorListHook*>(link_ ^ reinterpret_cast<uintptr_t>(neighbour));
+    }
+
+    // Заменяет соседа from на to
+    void Relink(const XorListHook* from, const XorListHook* to) {
+        link_ ^= reinterpret_cast<uintptr_t>(from) ^ reinterpret_cast<uintptr_t>(to);
+    }
+};
+
+// Двусвязный XOR-список: те же операции, что у List<T>, но в узле одно слово.
+// Удалять из середины по указателю на элемент нельзя — нужен сосед.
+template <typename T, typename Tag = DefaultListTag>
+class XorList {
+    using Hook = XorListHook<Tag>;
+
+public:
+    class Iterator {
+        using IteratorTag = std::bidirectional_iterator_tag;
+
+    public:
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef T* pointer;
+        typedef T& reference;
+        typedef IteratorTag iterator_category;
+
+        Iterator(Hook* prev, Hook* ptr) : prev_(prev), ptr_(ptr) {
+        }
+
+        Iterator& operator++() {
+            Hook* next = ptr_->Other(prev_);
+            prev_ = ptr_;
+            ptr_ = next;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator tmp(*this);
+            ++(*this);
+            return tmp;
+        }
+
+        Iterator& operator--() {
+            Hook* prev = prev_->Other(ptr_);
+            ptr_ = prev_;
+            prev_ = prev;
+            return *this;
+        }
+        Iterator operator--(int) {
+            Iterator tmp(*this);
+            --(*this);
+            return tmp;
+        }
+
+        reference operator*() const {
+            return static_cast<T&>(*ptr_);
+        }
+        pointer operator->() const {
+            return &static_cast<T&>(*ptr_);
+        }
+
+        bool operator==(const Iterator& rhs) const {
+            return ptr_ == rhs.ptr_;
+        }
+        bool operator!=(const Iterator& rhs) const {
+            return !(*this == rhs);
+        }
+
+    private:
+        Hook* prev_;
+        Hook* ptr_;
+    };
+
+    XorList() : head_(nullptr), tail_(nullptr) {
+    }
+
+    XorList(const XorList&) = delete;
+    XorList& operator=(const XorList&) = delete;
+
+    XorList(XorList&& other) noexcept : head_(other.head_), tail_(other.tail_) {
+        other.head_ = other.tail_ = nullptr;
+    }
+
+    XorList& operator=(XorList&& other) noexcept {
+        if (this != &other) {
+            head_ = other.head_;
+            tail_ = other.tail_;
+            other.head_ = other.tail_ = nullptr;
+        }
+        return *this;
+    }
+
+    bool IsEmpty() const {
+        return head_ == nullptr;
+    }
+
+    size_t Size() const {
+        size_t size = 0;
+        for (const Hook *prev = nullptr, *it = head_; it != nullptr;) {
+            const Hook* next = it->Other(prev);
+            prev = it;
+            it = next;
+            ++size;
+        }
+        return size;
+    }
+
+    void Clear() {
+        head_ = tail_ = nullptr;
+    }
+
+    void PushBack(T* elem) {
+        LinkAtEnd(static_cast<Hook*>(elem), &head_, &tail_);
+    }
+    void PushFront(T* elem) {
+        LinkAtEnd(static_cast<Hook*>(elem), &tail_, &head_);
+    }
+
+    T& Front() {
+        if (IsEmpty()) {
+            throw std::runtime_error("List is empty");
+        }
+        return static_cast<T&>(*head_);
+    }
+    const T& Front() const {
+        if (IsEmpty()) {
+            throw std::runtime_error("List is empty");
+        }
+        return static_cast<const T&>(*head_);
+    }
+
+    T& Back() {
+        if (IsEmpty()) {
+            throw std::runtime_error("List is empty");
+        }
+        return static_cast<T&>(*tail_);
+    }
+    const T& Back() const {
+        if (IsEmpty()) {
+            throw std::runtime_error("List is empty");
+        }
+        return static_cast<const T&>(*tail_);
+    }
+
+    void PopFront() {
+        if (IsEmpty()) {
+            throw std::runtime_error("List is empty");
+        }
+        UnlinkEnd(&head_, &tail_);
+    }
+    void PopBack() {
+        if (IsEmpty()) {
+            throw std::runtime_error("List is empty");
+        }
+        UnlinkEnd(&tail_, &head_);
+    }
+
+    Iterator Begin() {
+        return Iterator(nullptr, head_);
+    }
+    Iterator End() {
+        return Iterator(tail_, nullptr);
+    }
+
+private:
+    Hook* head_;
+    Hook* tail_;
+
+    // Вставка и удаление симметричны: меняются только роли head_ и tail_
+    static void LinkAtEnd(Hook* node, Hook** far_end, Hook** near_end) {
+        node->link_ = reinterpret_cast<uintptr_t>(*near_end);
+        if (*near_end == nullptr) {
+            *far_end = node;
+        } else {
+            (*near_end)->Relink(nullptr, node);
+        }
+        *near_end = node;
+    }
+
+    static void UnlinkEnd(Hook** near_end, Hook** far_end) {
+        Hook* node = *near_end;
+        Hook* next = node->Other(nullptr);
+        if (next == nullptr) {
+            *far_end = nullptr;
+        } else {
+            next->Relink(node, nullptr);
+        }
+        *near_end = next;
+    }
+};
+
+// free functions for range-based for
+template <typename T, typename Tag>
+typename SList<T, Tag>::Iterator begin(SList<T, Tag>& list) {  // NOLINT
+    return list.Begin();
+}
+
+template <typename T, typename Tag>
+typename SList<T, Tag>::Iterator end(SList<T, Tag>& list) {  // NOLINT
+    return list.End();
+}
+
+template <typename T, typename Tag>
+typename XorList<T, Tag>::Iterator begin(XorList<T, Tag>& list) {  // NOLINT
+    return list.Begin();
+}
+
+template <typename T, typename Tag>
+typename XorList<T, Tag>::Iterator end(XorList<T, Tag>& list) {  // NOLINT
+    return list.End();
+}
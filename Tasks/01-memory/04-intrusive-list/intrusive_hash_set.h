@@ -0,0 +1,231 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "intrusive_list.h"
+
+// Интрузивное хеш-множество: корзины — это TaggedList<T, Tag>, а узлом служит
+// TaggedListHook<Tag, ...> внутри самого объекта, так что на элемент
+// ничего не аллоцируется — только массив корзин.
+//
+// Рост таблицы инкрементальный: при превышении коэффициента заполнения
+// заводится таблица вдвое больше, и каждая операция переносит в неё пару
+// корзин из старой. Поиск во время переноса смотрит в обе таблицы.
+//
+// Hash и Equal могут принимать не только T, но и ключ другого типа K:
+// нужны hash(K) и equal(const T&, const K&) — тогда Find(key) не требует
+// создавать объект T для поиска.
+template <typename T, typename Hash = std::hash<T>, typename Equal = std::equal_to<>,
+          typename Tag = DefaultListTag>
+class IntrusiveHashSet {
+    using Bucket = TaggedList<T, Tag>;
+    using LinkMode = decltype(ListLinkModeOf<Tag>(static_cast<T*>(nullptr)));
+
+    static_assert(!std::is_same_v<LinkMode, AutoUnlink>,
+                  "IntrusiveHashSet needs SafeLink or NormalLink hooks: "
+                  "auto-unlink would bypass the element counter");
+
+    static constexpr size_t kInitialBuckets = 8;
+    static constexpr size_t kMigrateStep = 2;  // корзин за одну операцию
+
+public:
+    explicit IntrusiveHashSet(const Hash& hash = Hash(), const Equal& equal = Equal())
+        : hash_(hash), equal_(equal) {
+    }
+
+    IntrusiveHashSet(const IntrusiveHashSet&) = delete;
+    IntrusiveHashSet& operator=(const IntrusiveHashSet&) = delete;
+
+    ~IntrusiveHashSet() {
+        Clear();
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    bool IsEmpty() const {
+        return size_ == 0;
+    }
+
+    size_t BucketCount() const {
+        return table_.size;
+    }
+
+    bool IsRehashing() const {
+        return old_.buckets != nullptr;
+    }
+
+    // Заранее выделяет корзины под count элементов, чтобы вставки до этого
+    // размера не аллоцировали и не рехешировали
+    void Reserve(size_t count) {
+        size_t buckets = kInitialBuckets;
+        while (buckets < count) {
+            buckets *= 2;
+        }
+        if (buckets <= table_.size) {
+            return;
+        }
+        while (IsRehashing()) {
+            MigrateStep();
+        }
+        old_ = std::move(table_);
+        table_ = Table(buckets);
+        migrate_pos_ = 0;
+        while (IsRehashing()) {
+            MigrateStep();
+        }
+    }
+
+    // Вставляет elem, если равного ему ещё нет. Возвращает false, если есть
+    bool Insert(T* elem) {
+        return FindOrInsert(elem).second;
+    }
+
+    // Как Insert, но возвращает ещё и элемент с ключом elem: уже лежавший
+    // в множестве или сам elem, если он вставлен. Хеш считается один раз
+    std::pair<T*, bool> FindOrInsert(T* elem) {
+        MigrateStep();
+        const size_t hash = hash_(static_cast<const T&>(*elem));
+        if (T* found = FindWithHash(static_cast<const T&>(*elem), hash)) {
+            return {found, false};
+        }
+        if (table_.buckets == nullptr) {
+            table_ = Table(kInitialBuckets);
+        } else if (size_ + 1 > table_.size) {
+            Grow();
+        }
+        table_.BucketFor(hash).PushFront(elem);
+        ++size_;
+        return {elem, true};
+    }
+
+    template <class K>
+    T* Find(const K& key) {
+        MigrateStep();
+        return FindWithHash(key, hash_(key));
+    }
+
+    // Удаляет elem, который должен лежать в этом множестве
+    void Erase(T* elem) {
+        MigrateStep();
+        BucketOf(hash_(static_cast<const T&>(*elem))).Erase(elem);
+        --size_;
+    }
+
+    void Clear() {
+        old_.ClearAll();
+        table_.ClearAll();
+        old_ = Table();
+        migrate_pos_ = 0;
+        size_ = 0;
+    }
+
+    template <class Callback>
+    void ForEach(Callback&& callback) {
+        for (Table* table : {&old_, &table_}) {
+            for (size_t i = 0; i < table->size; ++i) {
+                for (T& elem : table->buckets[i]) {
+                    callback(elem);
+                }
+            }
+        }
+    }
+
+private:
+    struct Table {
+        std::unique_ptr<Bucket[]> buckets;
+        size_t size = 0;
+        int shift = 64;
+
+        Table() = default;
+
+        explicit Table(size_t count) : buckets(new Bucket[count]), size(count) {
+            for (size_t n = count; n > 1; n /= 2) {
+                --shift;
+            }
+        }
+
+        // Фибоначчиево хеширование: старшие биты произведения перемешаны лучше младших
+        size_t Index(size_t hash) const {
+            if (shift == 64) {
+                return 0;
+            }
+            return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >>
+                                       shift);
+        }
+
+        Bucket& BucketFor(size_t hash) {
+            return buckets[Index(hash)];
+        }
+
+        void ClearAll() {
+            for (size_t i = 0; i < size; ++i) {
+                buckets[i].Clear();
+            }
+        }
+    };
+
+    Table table_;        // куда вставляем
+    Table old_;          // откуда переносим, пока идёт рехеширование
+    size_t migrate_pos_ = 0;  // корзины old_ до этой уже перенесены
+    size_t size_ = 0;
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] Equal equal_;
+
+    Bucket& BucketOf(size_t hash) {
+        if (IsRehashing()) {
+            size_t old_index = old_.Index(hash);
+            if (old_index >= migrate_pos_) {
+                return old_.buckets[old_index];
+            }
+        }
+        return table_.BucketFor(hash);
+    }
+
+    template <class K>
+    T* FindWithHash(const K& key, size_t hash) {
+        if (table_.buckets == nullptr) {
+            return nullptr;
+        }
+        for (T& elem : BucketOf(hash)) {
+            if (equal_(static_cast<const T&>(elem), key)) {
+                return &elem;
+            }
+        }
+        return nullptr;
+    }
+
+    void Grow() {
+        while (IsRehashing()) {
+            MigrateStep();
+        }
+        old_ = std::move(table_);
+        table_ = Table(old_.size * 2);
+        migrate_pos_ = 0;
+    }
+
+    void MigrateStep() {
+        if (!IsRehashing()) {
+            return;
+        }
+        for (size_t step = 0; step < kMigrateStep && migrate_pos_ < old_.size; ++step) {
+            Bucket& bucket = old_.buckets[migrate_pos_];
+            while (!bucket.IsEmpty()) {
+                T* elem = &bucket.Front();
+                bucket.PopFront();
+                table_.BucketFor(hash_(static_cast<const T&>(*elem))).PushFront(elem);
+            }
+            ++migrate_pos_;
+        }
+        if (migrate_pos_ == old_.size) {
+            old_ = Table();
+            migrate_pos_ = 0;
+        }
+    }
+};
@@ -2,55 +2,105 @@
 
 #include <cassert>
 #include <cstddef>
+#include <functional>
 #include <iterator>
 #include <stdexcept>
+#include <type_traits>
+
+// Политики связывания хука
+struct AutoUnlink {};  // хук сам отлинковывается в деструкторе (по умолчанию)
+struct SafeLink {};    // отладочный режим: assert'ы на повторную вставку и смерть в списке
+struct NormalLink {};  // быстрый режим: никаких проверок и обнуления указателей
+
+// Тег по умолчанию. Свои теги позволяют объекту наследовать несколько
+// независимых хуков и одновременно лежать в нескольких списках (см. TaggedListHook)
+struct DefaultListTag {};
+
+// Политики размера списка
+struct UncountedSize {};  // Size() за O(n), список — только dummy-узел
+struct CountedSize {};    // Size() за O(1), список хранит счётчик
 
 // Узел для intrusive list
-class ListHook {
+template <class LinkMode = AutoUnlink, class Tag = DefaultListTag>
+class BasicListHook {
 public:
-    ListHook() : prev_(nullptr), next_(nullptr) {
+    BasicListHook() : prev_(nullptr), next_(nullptr) {
     }
-    ListHook(const ListHook&) = delete;
-    ListHook& operator=(const ListHook&) = delete;
-    ListHook(ListHook&&) = delete;
-    ListHook& operator=(ListHook&&) = delete;
-
-    ~ListHook() {
-        if (IsLinked()) {
-            Unlink();
+    BasicListHook(const BasicListHook&) = delete;
+    BasicListHook& operator=(const BasicListHook&) = delete;
+    BasicListHook(BasicListHook&&) = delete;
+    BasicListHook& operator=(BasicListHook&&) = delete;
+
+    ~BasicListHook() {
+        if constexpr (std::is_same_v<LinkMode, AutoUnlink>) {
+            if (IsLinked()) {
+                Unlink();
+            }
+        } else if constexpr (std::is_same_v<LinkMode, SafeLink>) {
+            assert(!IsLinked());
         }
     }
 
-    bool IsLinked() const {
+    // В режиме NormalLink указатели не обнуляются, так что узнать это нельзя
+    bool IsLinked() const requires(!std::is_same_v<LinkMode, NormalLink>) {
         return prev_ != nullptr && next_ != nullptr;
     }
 
-    void Unlink() {
+    // Отлинковаться в обход списка можно только в режиме AutoUnlink:
+    // список со счётчиком об этом бы не узнал
+    void Unlink() requires std::is_same_v<LinkMode, AutoUnlink> {
         assert(IsLinked());
-        prev_->next_ = next_;
-        next_->prev_ = prev_;
-        prev_ = nullptr;
-        next_ = nullptr;
+        UnlinkImpl();
     }
 
 private:
-    ListHook* prev_;
-    ListHook* next_;
+    BasicListHook* prev_;
+    BasicListHook* next_;
 
-    template <class T>
+    template <class T, class SizePolicy, class ListTag>
     friend class List;
 
-    void LinkBefore(ListHook* other) {
-        assert(!IsLinked());
+    void LinkBefore(BasicListHook* other) {
+        if constexpr (!std::is_same_v<LinkMode, NormalLink>) {
+            assert(!IsLinked());
+        }
         prev_ = other->prev_;
         next_ = other;
         other->prev_->next_ = this;
         other->prev_ = this;
     }
+
+    void UnlinkImpl() {
+        prev_->next_ = next_;
+        next_->prev_ = prev_;
+        if constexpr (!std::is_same_v<LinkMode, NormalLink>) {
+            prev_ = nullptr;
+            next_ = nullptr;
+        }
+    }
 };
 
-template <typename T>
+using ListHook = BasicListHook<>;
+
+// Хук с тегом: тег идёт первым, потому что без него такой хук не нужен
+template <class Tag, class LinkMode = AutoUnlink>
+using TaggedListHook = BasicListHook<LinkMode, Tag>;
+
+// Режим связывания хука с тегом Tag, от которого унаследован T
+template <class Tag, class LinkMode>
+LinkMode ListLinkModeOf(const BasicListHook<LinkMode, Tag>*);
+
+template <typename T, typename SizePolicy = UncountedSize, typename Tag = DefaultListTag>
 class List {
+    using LinkMode = decltype(ListLinkModeOf<Tag>(static_cast<T*>(nullptr)));
+    using Hook = BasicListHook<LinkMode, Tag>;
+
+    static constexpr bool kCounted = std::is_same_v<SizePolicy, CountedSize>;
+
+    static_assert(!kCounted || !std::is_same_v<LinkMode, AutoUnlink>,
+                  "CountedSize needs SafeLink or NormalLink hooks: "
+                  "auto-unlink would bypass the counter");
+
 public:
     class Iterator {
         using IteratorTag = std::bidirectional_iterator_tag;
@@ -62,7 +112,7 @@ public:
         typedef T& reference;
         typedef IteratorTag iterator_category;
 
-        Iterator(ListHook* ptr) : ptr_(ptr) {
+        Iterator(Hook* ptr) : ptr_(ptr) {
         }
 
         Iterator& operator++() {
@@ -100,7 +150,9 @@ public:
         }
 
     private:
-        ListHook* ptr_;
+        Hook* ptr_;
+
+        friend class List;
     };
 
     List() {
@@ -112,35 +164,21 @@ public:
     List& operator=(const List&) = delete;
 
     List(List&& other) noexcept {
-        if (other.IsEmpty()) {
-            dummy_.next_ = dummy_.prev_ = &dummy_;
-        } else {
-            dummy_.next_ = other.dummy_.next_;
-            dummy_.prev_ = other.dummy_.prev_;
-            dummy_.next_->prev_ = &dummy_;
-            dummy_.prev_->next_ = &dummy_;
-            other.dummy_.next_ = other.dummy_.prev_ = &other.dummy_;
-        }
+        StealFrom(other);
     }
 
     List& operator=(List&& other) noexcept {
         if (this != &other) {
             Clear();
-            if (other.IsEmpty()) {
-                dummy_.next_ = dummy_.prev_ = &dummy_;
-            } else {
-                dummy_.next_ = other.dummy_.next_;
-                dummy_.prev_ = other.dummy_.prev_;
-                dummy_.next_->prev_ = &dummy_;
-                dummy_.prev_->next_ = &dummy_;
-                other.dummy_.next_ = other.dummy_.prev_ = &other.dummy_;
-            }
+            StealFrom(other);
         }
         return *this;
     }
 
     ~List() {
         Clear();
+        // dummy не должен выглядеть прилинкованным для своего деструктора
+        dummy_.next_ = dummy_.prev_ = nullptr;
     }
 
     bool IsEmpty() const {
@@ -148,24 +186,42 @@ public:
     }
 
     size_t Size() const {
-        size_t size = 0;
-        for (auto* it = dummy_.next_; it != &dummy_; it = it->next_) {
-            ++size;
+        if constexpr (kCounted) {
+            return size_;
+        } else {
+            size_t size = 0;
+            for (auto* it = dummy_.next_; it != &dummy_; it = it->next_) {
+                ++size;
+            }
+            return size;
         }
-        return size;
     }
 
     void Clear() {
-        while (!IsEmpty()) {
-            PopFront();
+        if constexpr (std::is_same_v<LinkMode, NormalLink>) {
+            // узлам нечего сбрасывать — просто забываем о них
+            dummy_.next_ = dummy_.prev_ = &dummy_;
+            if constexpr (kCounted) {
+                size_ = 0;
+            }
+        } else {
+            while (!IsEmpty()) {
+                PopFront();
+            }
         }
     }
 
     void PushBack(T* elem) {
-        elem->LinkBefore(&dummy_);
+        ToHook(elem)->LinkBefore(&dummy_);
+        if constexpr (kCounted) {
+            ++size_;
+        }
     }
     void PushFront(T* elem) {
-        elem->LinkBefore(dummy_.next_);
+        ToHook(elem)->LinkBefore(dummy_.next_);
+        if constexpr (kCounted) {
+            ++size_;
+        }
     }
 
     T& Front() {
@@ -198,13 +254,18 @@ public:
         if (IsEmpty()) {
             throw std::runtime_error("List is empty");
         }
-        dummy_.next_->Unlink();
+        UnlinkNode(dummy_.next_);
     }
     void PopBack() {
         if (IsEmpty()) {
             throw std::runtime_error("List is empty");
         }
-        dummy_.prev_->Unlink();
+        UnlinkNode(dummy_.prev_);
+    }
+
+    // Удаляет elem, который должен лежать в этом списке
+    void Erase(T* elem) {
+        UnlinkNode(ToHook(elem));
     }
 
     Iterator Begin() {
@@ -215,20 +276,249 @@ public:
     }
 
     Iterator IteratorTo(T* element) {
-        return Iterator(static_cast<ListHook*>(element));
+        return Iterator(ToHook(element));
+    }
+
+    // Переносит [first, last) из other перед pos без аллокаций.
+    // O(1), если other — это *this или размер не считается; иначе O(длины диапазона)
+    void Splice(Iterator pos, List& other, Iterator first, Iterator last) {
+        if (first == last) {
+            return;
+        }
+        if constexpr (kCounted) {
+            if (&other != this) {
+                size_t count = 0;
+                for (Hook* it = first.ptr_; it != last.ptr_; it = it->next_) {
+                    ++count;
+                }
+                size_ += count;
+                other.size_ -= count;
+            }
+        }
+        Transfer(pos.ptr_, first.ptr_, last.ptr_);
+    }
+
+    // Переносит один элемент it из other перед pos
+    void Splice(Iterator pos, List& other, Iterator it) {
+        Iterator next = it;
+        ++next;
+        if (pos == it || pos == next) {
+            return;
+        }
+        Splice(pos, other, it, next);
+    }
+
+    // Переносит весь other перед pos за O(1)
+    void Splice(Iterator pos, List& other) {
+        if (&other == this || other.IsEmpty()) {
+            return;
+        }
+        Transfer(pos.ptr_, other.dummy_.next_, &other.dummy_);
+        if constexpr (kCounted) {
+            size_ += other.size_;
+            other.size_ = 0;
+        }
+    }
+
+    // Сливает отсортированный other в отсортированный *this за линейное время.
+    // Устойчиво: из равных элементов первыми идут элементы *this.
+    // Между вызовами comp оба списка целые, так что если comp бросит, часть
+    // other уже будет на своих местах в *this, а остальное — в other
+    template <class Compare = std::less<T>>
+    void Merge(List& other, Compare comp = Compare()) {
+        if (&other == this) {
+            return;
+        }
+        Hook* it = dummy_.next_;
+        Hook* from = other.dummy_.next_;
+        while (from != &other.dummy_) {
+            while (it != &dummy_ && !comp(AsT(from), AsT(it))) {
+                it = it->next_;
+            }
+            if (it == &dummy_) {
+                Transfer(&dummy_, from, &other.dummy_);
+                break;
+            }
+            // переносим сразу всю серию элементов other, меньших *it
+            Hook* run_end = from->next_;
+            size_t run_size = 1;
+            while (run_end != &other.dummy_ && comp(AsT(run_end), AsT(it))) {
+                run_end = run_end->next_;
+                ++run_size;
+            }
+            Transfer(it, from, run_end);
+            from = run_end;
+            if constexpr (kCounted) {
+                size_ += run_size;
+                other.size_ -= run_size;
+            }
+        }
+        if constexpr (kCounted) {
+            size_ += other.size_;
+            other.size_ = 0;
+        }
+    }
+
+    // Устойчивая восходящая сортировка слиянием: O(n log n), перелинковывает
+    // узлы на месте и не выделяет памяти. Если comp бросит, все элементы
+    // останутся в списке в неопределённом порядке, как у std::list::sort
+    template <class Compare = std::less<T>>
+    void Sort(Compare comp = Compare()) {
+        if (dummy_.next_ == dummy_.prev_) {
+            return;
+        }
+        // на время сортировки список — односвязная цепочка по next_
+        dummy_.prev_->next_ = nullptr;
+        Hook* head = dummy_.next_;
+        Hook* tail = nullptr;    // конец уже слитой части текущего прохода
+        Hook* left = nullptr;    // остаток левой серии, left_size узлов
+        Hook* right = nullptr;   // остаток правой серии и все ещё не тронутые узлы
+        size_t left_size = 0;
+
+        try {
+            for (size_t width = 1;; width *= 2) {
+                left = head;
+                tail = nullptr;
+                head = nullptr;
+                size_t merges = 0;
+
+                while (left != nullptr) {
+                    ++merges;
+                    right = left;
+                    left_size = 0;
+                    while (left_size < width && right != nullptr) {
+                        ++left_size;
+                        right = right->next_;
+                    }
+                    size_t right_size = width;
+
+                    while (left_size > 0 || (right_size > 0 && right != nullptr)) {
+                        Hook* next;
+                        // при равенстве берём слева — так сортировка устойчива
+                        if (left_size == 0 || (right_size > 0 && right != nullptr &&
+                                               comp(AsT(right), AsT(left)))) {
+                            next = right;
+                            right = right->next_;
+                            --right_size;
+                        } else {
+                            next = left;
+                            left = left->next_;
+                            --left_size;
+                        }
+                        if (tail == nullptr) {
+                            head = next;
+                        } else {
+                            tail->next_ = next;
+                        }
+                        tail = next;
+                    }
+                    left = right;
+                }
+                tail->next_ = nullptr;
+
+                if (merges <= 1) {
+                    break;
+                }
+            }
+        } catch (...) {
+            // слитая часть прохода кончается на tail, за ней — left_size узлов
+            // левой серии и цепочка от right до конца
+            Hook* prev = &dummy_;
+            for (Hook* it = tail != nullptr ? head : nullptr; it != nullptr;) {
+                Hook* next = it == tail ? nullptr : it->next_;
+                prev = LinkAfter(prev, it);
+                it = next;
+            }
+            for (; left_size > 0; --left_size, left = left->next_) {
+                prev = LinkAfter(prev, left);
+            }
+            for (; right != nullptr; right = right->next_) {
+                prev = LinkAfter(prev, right);
+            }
+            prev->next_ = &dummy_;
+            dummy_.prev_ = prev;
+            throw;
+        }
+
+        // восстанавливаем prev_ и замыкаем кольцо через dummy
+        Hook* prev = &dummy_;
+        for (Hook* it = head; it != nullptr; it = it->next_) {
+            prev = LinkAfter(prev, it);
+        }
+        prev->next_ = &dummy_;
+        dummy_.prev_ = prev;
     }
 
 private:
-    ListHook dummy_;
+    Hook dummy_;
+    [[no_unique_address]] std::conditional_t<kCounted, size_t, std::false_type> size_{};
+
+    static Hook* ToHook(T* elem) {
+        return static_cast<Hook*>(elem);
+    }
+
+    static const T& AsT(Hook* node) {
+        return static_cast<const T&>(*node);
+    }
+
+    // Ставит node следом за prev, не трогая node->next_; возвращает node
+    static Hook* LinkAfter(Hook* prev, Hook* node) {
+        prev->next_ = node;
+        node->prev_ = prev;
+        return node;
+    }
+
+    // Переносит узлы [first, last) перед pos; pos не должен лежать внутри диапазона
+    static void Transfer(Hook* pos, Hook* first, Hook* last) {
+        if (first == last) {
+            return;
+        }
+        Hook* last_inside = last->prev_;
+        first->prev_->next_ = last;
+        last->prev_ = first->prev_;
+
+        Hook* before = pos->prev_;
+        before->next_ = first;
+        first->prev_ = before;
+        last_inside->next_ = pos;
+        pos->prev_ = last_inside;
+    }
+
+    void UnlinkNode(Hook* node) {
+        node->UnlinkImpl();
+        if constexpr (kCounted) {
+            --size_;
+        }
+    }
+
+    void StealFrom(List& other) {
+        if (other.IsEmpty()) {
+            dummy_.next_ = dummy_.prev_ = &dummy_;
+        } else {
+            dummy_.next_ = other.dummy_.next_;
+            dummy_.prev_ = other.dummy_.prev_;
+            dummy_.next_->prev_ = &dummy_;
+            dummy_.prev_->next_ = &dummy_;
+            other.dummy_.next_ = other.dummy_.prev_ = &other.dummy_;
+        }
+        if constexpr (kCounted) {
+            size_ = other.size_;
+            other.size_ = 0;
+        }
+    }
 };
 
+// Список по хуку TaggedListHook<Tag>
+template <typename T, typename Tag, typename SizePolicy = UncountedSize>
+using TaggedList = List<T, SizePolicy, Tag>;
+
 // free functions for range-based for
-template <typename T>
-typename List<T>::Iterator begin(List<T>& list) {  // NOLINT
+template <typename T, typename SizePolicy, typename Tag>
+typename List<T, SizePolicy, Tag>::Iterator begin(List<T, SizePolicy, Tag>& list) {  // NOLINT
     return list.Begin();
 }
 
-template <typename T>
-typename List<T>::Iterator end(List<T>& list) {  // NOLINT
+template <typename T, typename SizePolicy, typename Tag>
+typename List<T, SizePolicy, Tag>::Iterator end(List<T, SizePolicy, Tag>& list) {  // NOLINT
     return list.End();
 }
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+#include "intrusive_hash_set.h"
+#include "intrusive_list.h"
+
+struct LruListTag {};
+struct LruIndexTag {};
+
+// Оба хука LRU-индекса: позиция в списке обращений и звено в хеш-корзине
+struct IntrusiveLruHook : public TaggedListHook<LruListTag, SafeLink>,
+                          public TaggedListHook<LruIndexTag, SafeLink> {};
+
+// LRU-индекс над объектами, которые уже где-то живут и наследуют IntrusiveLruHook.
+// В отличие от LruCache, не хранит ни узлов списка, ни узлов мапы: корзины хеш-индекса
+// выделяются один раз в конструкторе, а Insert, Get и вытеснение только перелинковывают
+// хуки. Индекс не владеет объектами — вытесненные отдаются обратно вызывающему.
+template <typename T, typename Hash, typename Equal = std::equal_to<>>
+class IntrusiveLru {
+public:
+    explicit IntrusiveLru(size_t max_size, const Hash& hash = Hash(), const Equal& equal = Equal())
+        : max_size_(max_size), index_(hash, equal) {
+        // новый объект попадает в индекс раньше, чем вытесняется старый
+        index_.Reserve(max_size + 1);
+    }
+
+    IntrusiveLru(const IntrusiveLru&) = delete;
+    IntrusiveLru& operator=(const IntrusiveLru&) = delete;
+
+    ~IntrusiveLru() {
+        Clear();
+    }
+
+    size_t Size() const {
+        return index_.Size();
+    }
+
+    size_t MaxSize() const {
+        return max_size_;
+    }
+
+    bool IsEmpty() const {
+        return index_.IsEmpty();
+    }
+
+    // Корзины индекса выделены в конструкторе и дальше не меняются
+    size_t BucketCount() const {
+        return index_.BucketCount();
+    }
+
+    // Кладёт elem как самый свежий. Возвращает объект, оставшийся вне индекса:
+    // вытесненный самый старый, сам elem, если равный ключ уже есть, или nullptr
+    T* Insert(T* elem) {
+        if (max_size_ == 0) {
+            return elem;
+        }
+        if (!index_.FindOrInsert(elem).second) {
+            return elem;
+        }
+        order_.PushBack(elem);
+        return Size() > max_size_ ? PopOldest() : nullptr;
+    }
+
+    // Находит объект по ключу и делает его самым свежим
+    template <class K>
+    T* Get(const K& key) {
+        T* elem = index_.Find(key);
+        if (elem != nullptr) {
+            order_.Splice(order_.End(), order_, order_.IteratorTo(elem));
+        }
+        return elem;
+    }
+
+    // Находит объект, не меняя порядок вытеснения
+    template <class K>
+    T* Peek(const K& key) {
+        return index_.Find(key);
+    }
+
+    // Вынимает самый старый объект, nullptr если индекс пуст
+    T* PopOldest() {
+        if (order_.IsEmpty()) {
+            return nullptr;
+        }
+        T* oldest = &order_.Front();
+        Erase(oldest);
+        return oldest;
+    }
+
+    // Удаляет elem, который должен лежать в индексе
+    void Erase(T* elem) {
+        order_.Erase(elem);
+        index_.Erase(elem);
+    }
+
+    void Clear() {
+        order_.Clear();
+        index_.Clear();
+    }
+
+private:
+    size_t max_size_;
+    // начало списка — самое старое обращение, конец — самое свежее
+    TaggedList<T, LruListTag> order_;
+    IntrusiveHashSet<T, Hash, Equal, LruIndexTag> index_;
+};
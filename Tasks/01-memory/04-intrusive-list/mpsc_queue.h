@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "intrusive_list.h"
+
+// Узел для интрузивной MPSC-очереди: один атомарный указатель вместо пары у ListHook.
+// Пока узел в очереди, его нельзя уничтожать или класть в другую очередь с тем же тегом.
+template <class Tag = DefaultListTag>
+class MpscQueueHook {
+public:
+    MpscQueueHook() : next_(nullptr) {
+    }
+    MpscQueueHook(const MpscQueueHook&) = delete;
+    MpscQueueHook& operator=(const MpscQueueHook&) = delete;
+    MpscQueueHook(MpscQueueHook&&) = delete;
+    MpscQueueHook& operator=(MpscQueueHook&&) = delete;
+
+private:
+    std::atomic<MpscQueueHook*> next_;
+
+    template <class T, class QueueTag>
+    friend class MpscQueue;
+};
+
+// Очередь Вьюкова: много производителей, один потребитель, без аллокаций.
+// Push — один atomic exchange, потребитель забирает элементы пачками через Drain.
+template <typename T, typename Tag = DefaultListTag>
+class MpscQueue {
+    using Hook = MpscQueueHook<Tag>;
+
+public:
+    MpscQueue() : head_(&stub_), tail_(&stub_) {
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Можно звать из любого потока
+    void Push(T* elem) {
+        PushHook(static_cast<Hook*>(elem));
+    }
+
+    // Только поток-потребитель. Возвращает nullptr, если очередь пуста или
+    // производитель ещё не дописал ссылку на свой узел (тогда стоит повторить позже)
+    T* Pop() {
+        Hook* tail = tail_;
+        Hook* next = tail->next_.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            tail_ = next;
+            tail = next;
+            next = next->next_.load(std::memory_order_acquire);
+        }
+        if (next != nullptr) {
+            tail_ = next;
+            return static_cast<T*>(tail);
+        }
+        if (tail != head_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        // tail — последний узел: вставляем stub, чтобы его можно было отдать
+        PushHook(&stub_);
+        next = tail->next_.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            tail_ = next;
+            return static_cast<T*>(tail);
+        }
+        return nullptr;
+    }
+
+    // Только поток-потребитель. Отдаёт callback'у не больше max_batch элементов
+    // в порядке вставки и возвращает их число
+    template <class Callback>
+    size_t Drain(Callback&& callback, size_t max_batch = static_cast<size_t>(-1)) {
+        size_t count = 0;
+        while (count < max_batch) {
+            T* elem = Pop();
+            if (elem == nullptr) {
+                break;
+            }
+            callback(elem);
+            ++count;
+        }
+        return count;
+    }
+
+    // Только поток-потребитель; при конкурентных Push ответ сразу устаревает
+    bool IsEmpty() const {
+        return tail_ == &stub_ && stub_.next_.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    alignas(64) std::atomic<Hook*> head_;  // сюда пишут производители
+    alignas(64) Hook* tail_;               // отсюда читает потребитель
+    Hook stub_;
+
+    void PushHook(Hook* node) {
+        node->next_.store(nullptr, std::memory_order_relaxed);
+        Hook* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next_.store(node, std::memory_order_release);
+    }
+};
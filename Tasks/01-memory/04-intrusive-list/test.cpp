@@ -1,9 +1,20 @@
 #include <catch.hpp>
 
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include <compact_list.h>
+#include <intrusive_hash_set.h>
 #include <intrusive_list.h>
+#include <intrusive_lru.h>
+#include <mpsc_queue.h>
+#include <allocations_checker.h>
 
 struct Item : public ListHook {
     explicit Item(int i) : i(i), blob("abcdefgh") {
@@ -192,3 +203,641 @@ TEST_CASE("Move works", "[IntrusiveList]") {
     REQUIRE(!l1.IsEmpty());
     REQUIRE(l2.IsEmpty());
 }
+
+struct SafeItem : public BasicListHook<SafeLink> {
+    explicit SafeItem(int i) : i(i) {
+    }
+
+    int i;
+};
+
+struct FastItem : public BasicListHook<NormalLink> {
+    explicit FastItem(int i) : i(i) {
+    }
+
+    int i;
+};
+
+TEST_CASE("Uncounted list carries no extra fields", "[IntrusiveList]") {
+    REQUIRE(sizeof(List<Item>) == 2 * sizeof(void*));
+    REQUIRE(sizeof(List<FastItem>) == 2 * sizeof(void*));
+    REQUIRE(sizeof(List<SafeItem, CountedSize>) == 2 * sizeof(void*) + sizeof(size_t));
+}
+
+TEST_CASE("Counted size works", "[IntrusiveList]") {
+    SafeItem i1(1), i2(2), i3(3);
+    List<SafeItem, CountedSize> l;
+    REQUIRE(l.Size() == 0);
+
+    l.PushBack(&i1);
+    l.PushBack(&i2);
+    l.PushFront(&i3);
+    REQUIRE(l.Size() == 3);
+    REQUIRE(l.Front().i == 3);
+
+    l.Erase(&i1);
+    REQUIRE(!i1.IsLinked());
+    REQUIRE(l.Size() == 2);
+    REQUIRE(l.Back().i == 2);
+
+    List<SafeItem, CountedSize> l2(std::move(l));
+    REQUIRE(l.Size() == 0);
+    REQUIRE(l2.Size() == 2);
+
+    l2.PopBack();
+    REQUIRE(l2.Size() == 1);
+
+    l = std::move(l2);
+    REQUIRE(l.Size() == 1);
+    REQUIRE(l2.Size() == 0);
+
+    l.Clear();
+    REQUIRE(l.Size() == 0);
+    REQUIRE(!i3.IsLinked());
+}
+
+TEST_CASE("Normal link mode", "[IntrusiveList]") {
+    FastItem i1(1), i2(2), i3(3);
+    List<FastItem, CountedSize> l;
+    l.PushBack(&i1);
+    l.PushBack(&i2);
+    l.PushBack(&i3);
+    REQUIRE(l.Size() == 3);
+
+    l.Erase(&i2);
+    int expected[] = {1, 3};
+    int idx = 0;
+    for (FastItem& v : l) {
+        REQUIRE(v.i == expected[idx++]);
+    }
+    REQUIRE(idx == 2);
+
+    l.Clear();
+    REQUIRE(l.IsEmpty());
+    REQUIRE(l.Size() == 0);
+
+    // после Clear узлы можно вставлять снова
+    l.PushBack(&i2);
+    REQUIRE(l.Front().i == 2);
+}
+
+struct LruTag {};
+struct TenantTag {};
+
+struct MultiItem : public TaggedListHook<LruTag>, public TaggedListHook<TenantTag> {
+    explicit MultiItem(int i) : i(i) {
+    }
+
+    int i;
+};
+
+TEST_CASE("One object in several lists", "[IntrusiveList]") {
+    MultiItem i1(1), i2(2), i3(3);
+    TaggedList<MultiItem, LruTag> lru;
+    TaggedList<MultiItem, TenantTag> tenant;
+
+    lru.PushBack(&i1);
+    lru.PushBack(&i2);
+    lru.PushBack(&i3);
+    tenant.PushFront(&i1);
+    tenant.PushFront(&i3);
+
+    REQUIRE(lru.Size() == 3);
+    REQUIRE(tenant.Size() == 2);
+    REQUIRE(lru.Front().i == 1);
+    REQUIRE(tenant.Front().i == 3);
+
+    // отлинковка из одного списка не трогает другой
+    static_cast<TaggedListHook<LruTag>&>(i1).Unlink();
+    REQUIRE(lru.Front().i == 2);
+    REQUIRE(tenant.Back().i == 1);
+    REQUIRE(static_cast<TaggedListHook<TenantTag>&>(i1).IsLinked());
+
+    int expected[] = {3, 1};
+    int idx = 0;
+    for (MultiItem& v : tenant) {
+        REQUIRE(v.i == expected[idx++]);
+    }
+    REQUIRE(idx == 2);
+
+    REQUIRE(&*lru.IteratorTo(&i3) == &i3);
+    REQUIRE(&*tenant.IteratorTo(&i3) == &i3);
+}
+
+struct Task : public MpscQueueHook<> {
+    Task() = default;
+    Task(int producer, int seq) : producer(producer), seq(seq) {
+    }
+
+    int producer = 0;
+    int seq = 0;
+};
+
+TEST_CASE("MpscQueue keeps FIFO order", "[MpscQueue]") {
+    MpscQueue<Task> q;
+    REQUIRE(q.IsEmpty());
+    REQUIRE(q.Pop() == nullptr);
+
+    Task t1(0, 1), t2(0, 2), t3(0, 3);
+    q.Push(&t1);
+    REQUIRE(!q.IsEmpty());
+    REQUIRE(q.Pop() == &t1);
+    REQUIRE(q.IsEmpty());
+
+    q.Push(&t2);
+    q.Push(&t3);
+    q.Push(&t1);  // узел можно переиспользовать после Pop
+    std::vector<int> seen;
+    REQUIRE(q.Drain([&](Task* t) { seen.push_back(t->seq); }, 2) == 2);
+    REQUIRE(q.Drain([&](Task* t) { seen.push_back(t->seq); }) == 1);
+    REQUIRE(seen == std::vector<int>{2, 3, 1});
+    REQUIRE(q.IsEmpty());
+}
+
+TEST_CASE("MpscQueue with several producers", "[MpscQueue]") {
+    const int producers = 4;
+    const int per_producer = 20000;
+    std::vector<std::vector<Task>> tasks(producers);
+    for (int p = 0; p < producers; ++p) {
+        tasks[p] = std::vector<Task>(per_producer);
+        for (int i = 0; i < per_producer; ++i) {
+            tasks[p][i].producer = p;
+            tasks[p][i].seq = i;
+        }
+    }
+
+    MpscQueue<Task> q;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (auto& t : tasks[p]) {
+                q.Push(&t);
+            }
+        });
+    }
+
+    std::vector<int> next_seq(producers, 0);
+    int received = 0;
+    bool ordered = true;
+    while (received < producers * per_producer) {
+        received += q.Drain([&](Task* t) {
+            ordered = ordered && t->seq == next_seq[t->producer];
+            ++next_seq[t->producer];
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    REQUIRE(ordered);
+    REQUIRE(q.IsEmpty());
+    for (int p = 0; p < producers; ++p) {
+        REQUIRE(next_seq[p] == per_producer);
+    }
+}
+
+struct SmallItem : public SListHook<>, public XorListHook<> {
+    explicit SmallItem(int i) : i(i) {
+    }
+
+    int i;
+};
+
+TEST_CASE("Compact hooks take one pointer", "[CompactList]") {
+    REQUIRE(sizeof(SListHook<>) == sizeof(void*));
+    REQUIRE(sizeof(XorListHook<>) == sizeof(void*));
+}
+
+TEST_CASE("SList works", "[CompactList]") {
+    SmallItem i1(1), i2(2), i3(3);
+    SList<SmallItem> l;
+    REQUIRE(l.IsEmpty());
+    REQUIRE(l.Size() == 0);
+
+    l.PushBack(&i2);
+    l.PushBack(&i3);
+    l.PushFront(&i1);
+    REQUIRE(l.Size() == 3);
+    REQUIRE(l.Front().i == 1);
+    REQUIRE(l.Back().i == 3);
+
+    int i = 0;
+    for (SmallItem& v : l) {
+        REQUIRE(v.i == ++i);
+    }
+    REQUIRE(i == 3);
+
+    SList<SmallItem> l2(std::move(l));
+    REQUIRE(l.IsEmpty());
+    l2.PopFront();
+    l2.PopFront();
+    REQUIRE(l2.Front().i == 3);
+    REQUIRE(l2.Back().i == 3);
+    l2.PopFront();
+    REQUIRE(l2.IsEmpty());
+    REQUIRE_THROWS(l2.PopFront());
+
+    l2.PushBack(&i1);
+    REQUIRE(l2.Back().i == 1);
+}
+
+TEST_CASE("XorList works", "[CompactList]") {
+    SmallItem i1(1), i2(2), i3(3), i4(4);
+    XorList<SmallItem> l;
+    REQUIRE(l.IsEmpty());
+
+    l.PushBack(&i2);
+    l.PushBack(&i3);
+    l.PushFront(&i1);
+    l.PushBack(&i4);
+    REQUIRE(l.Size() == 4);
+    REQUIRE(l.Front().i == 1);
+    REQUIRE(l.Back().i == 4);
+
+    int i = 0;
+    for (SmallItem& v : l) {
+        REQUIRE(v.i == ++i);
+    }
+    REQUIRE(i == 4);
+
+    auto it = l.End();
+    for (int j = 4; j >= 1; --j) {
+        --it;
+        REQUIRE(it->i == j);
+    }
+    REQUIRE(it == l.Begin());
+
+    l.PopFront();
+    l.PopBack();
+    REQUIRE(l.Front().i == 2);
+    REQUIRE(l.Back().i == 3);
+
+    XorList<SmallItem> l2;
+    l2 = std::move(l);
+    REQUIRE(l.IsEmpty());
+    l2.PopBack();
+    l2.PopBack();
+    REQUIRE(l2.IsEmpty());
+    REQUIRE_THROWS(l2.PopBack());
+
+    // один объект сразу в SList и XorList
+    SList<SmallItem> s;
+    s.PushBack(&i1);
+    l2.PushFront(&i1);
+    REQUIRE(&s.Front() == &l2.Back());
+}
+
+template <class L>
+std::vector<int> Values(L& list) {
+    std::vector<int> values;
+    for (auto& v : list) {
+        values.push_back(v.i);
+    }
+    return values;
+}
+
+TEST_CASE("Splice works", "[IntrusiveList]") {
+    Item i1(1), i2(2), i3(3), i4(4), i5(5);
+    List<Item> a, b;
+    a.PushBack(&i1);
+    a.PushBack(&i5);
+    b.PushBack(&i2);
+    b.PushBack(&i3);
+    b.PushBack(&i4);
+
+    auto last = b.End();
+    --last;
+    a.Splice(a.IteratorTo(&i5), b, b.Begin(), last);
+    REQUIRE(Values(a) == std::vector<int>{1, 2, 3, 5});
+    REQUIRE(Values(b) == std::vector<int>{4});
+
+    a.Splice(a.IteratorTo(&i5), b, b.Begin());
+    REQUIRE(Values(a) == std::vector<int>{1, 2, 3, 4, 5});
+    REQUIRE(b.IsEmpty());
+
+    // внутри одного списка
+    a.Splice(a.Begin(), a, a.IteratorTo(&i4), a.End());
+    REQUIRE(Values(a) == std::vector<int>{4, 5, 1, 2, 3});
+
+    b.Splice(b.End(), a);
+    REQUIRE(a.IsEmpty());
+    REQUIRE(Values(b) == std::vector<int>{4, 5, 1, 2, 3});
+}
+
+TEST_CASE("Splice keeps counted size", "[IntrusiveList]") {
+    SafeItem i1(1), i2(2), i3(3), i4(4);
+    List<SafeItem, CountedSize> a, b;
+    a.PushBack(&i1);
+    a.PushBack(&i2);
+    b.PushBack(&i3);
+    b.PushBack(&i4);
+
+    a.Splice(a.End(), b, b.Begin());
+    REQUIRE(a.Size() == 3);
+    REQUIRE(b.Size() == 1);
+
+    b.Splice(b.Begin(), a);
+    REQUIRE(a.Size() == 0);
+    REQUIRE(b.Size() == 4);
+    REQUIRE(Values(b) == std::vector<int>{1, 2, 3, 4});
+
+    b.Clear();
+}
+
+struct KeyedItem : public ListHook {
+    KeyedItem(int key, int i) : key(key), i(i) {
+    }
+
+    int key;
+    int i;  // исходная позиция, чтобы проверять устойчивость
+};
+
+TEST_CASE("Merge is stable", "[IntrusiveList]") {
+    KeyedItem a1(1, 0), a2(3, 1), a3(3, 2), a4(7, 3);
+    KeyedItem b1(0, 4), b2(3, 5), b3(5, 6), b4(9, 7), b5(9, 8);
+    List<KeyedItem> a, b;
+    for (auto* item : {&a1, &a2, &a3, &a4}) {
+        a.PushBack(item);
+    }
+    for (auto* item : {&b1, &b2, &b3, &b4, &b5}) {
+        b.PushBack(item);
+    }
+
+    a.Merge(b, [](const KeyedItem& x, const KeyedItem& y) { return x.key < y.key; });
+    REQUIRE(b.IsEmpty());
+    REQUIRE(Values(a) == std::vector<int>{4, 0, 1, 2, 5, 6, 3, 7, 8});
+}
+
+TEST_CASE("Sort is stable", "[IntrusiveList]") {
+    std::mt19937 gen(20250917);
+    for (int size : {0, 1, 2, 3, 7, 64, 1000, 4097}) {
+        std::vector<std::unique_ptr<KeyedItem>> items;
+        List<KeyedItem> l;
+        for (int i = 0; i < size; ++i) {
+            items.push_back(std::make_unique<KeyedItem>(static_cast<int>(gen() % 50), i));
+            l.PushBack(items.back().get());
+        }
+
+        auto by_key = [](const KeyedItem& x, const KeyedItem& y) { return x.key < y.key; };
+        l.Sort(by_key);
+
+        std::vector<KeyedItem*> expected;
+        for (auto& item : items) {
+            expected.push_back(item.get());
+        }
+        std::stable_sort(expected.begin(), expected.end(),
+                         [&](KeyedItem* x, KeyedItem* y) { return by_key(*x, *y); });
+
+        std::vector<KeyedItem*> actual;
+        for (auto& v : l) {
+            actual.push_back(&v);
+        }
+        REQUIRE(actual == expected);
+
+        // prev-указатели тоже корректны
+        std::vector<KeyedItem*> backwards;
+        for (auto it = l.End(); it != l.Begin();) {
+            --it;
+            backwards.push_back(&*it);
+        }
+        std::reverse(backwards.begin(), backwards.end());
+        REQUIRE(backwards == expected);
+    }
+}
+
+TEST_CASE("Sort keeps the list intact when the comparator throws", "[IntrusiveList]") {
+    std::mt19937 gen(20251018);
+    for (int throw_at : {0, 1, 5, 40, 300}) {
+        std::vector<std::unique_ptr<KeyedItem>> items;
+        List<KeyedItem> l;
+        for (int i = 0; i < 100; ++i) {
+            items.push_back(std::make_unique<KeyedItem>(static_cast<int>(gen() % 50), i));
+            l.PushBack(items.back().get());
+        }
+
+        int calls = 0;
+        auto throwing = [&](const KeyedItem& x, const KeyedItem& y) {
+            if (calls++ == throw_at) {
+                throw std::runtime_error("comparator");
+            }
+            return x.key < y.key;
+        };
+        REQUIRE_THROWS_AS(l.Sort(throwing), std::runtime_error);
+
+        std::vector<int> forward = Values(l);
+        std::vector<int> backwards;
+        for (auto it = l.End(); it != l.Begin();) {
+            --it;
+            backwards.push_back(it->i);
+        }
+        std::reverse(backwards.begin(), backwards.end());
+        REQUIRE(forward == backwards);
+        std::sort(forward.begin(), forward.end());
+        std::vector<int> all(100);
+        std::iota(all.begin(), all.end(), 0);
+        REQUIRE(forward == all);
+        // дальше элементы отлинковываются сами в деструкторах
+    }
+}
+
+TEST_CASE("Merge keeps counted sizes when the comparator throws", "[IntrusiveList]") {
+    for (int throw_at : {0, 1, 3, 6}) {
+        std::vector<std::unique_ptr<SafeItem>> items;
+        List<SafeItem, CountedSize> a, b;
+        for (int i = 0; i < 10; ++i) {
+            items.push_back(std::make_unique<SafeItem>(i));
+            (i % 2 == 0 ? a : b).PushBack(items.back().get());
+        }
+
+        int calls = 0;
+        auto throwing = [&](const SafeItem& x, const SafeItem& y) {
+            if (calls++ == throw_at) {
+                throw std::runtime_error("comparator");
+            }
+            return x.i < y.i;
+        };
+        REQUIRE_THROWS_AS(a.Merge(b, throwing), std::runtime_error);
+
+        std::vector<int> merged = Values(a);
+        REQUIRE(a.Size() == merged.size());
+        REQUIRE(b.Size() == Values(b).size());
+        REQUIRE(a.Size() + b.Size() == 10);
+        REQUIRE(std::is_sorted(merged.begin(), merged.end()));
+        a.Clear();
+        b.Clear();
+    }
+}
+
+struct HashTag {};
+
+struct Entry : public TaggedListHook<HashTag, SafeLink> {
+    explicit Entry(int key) : key(key) {
+    }
+
+    int key;
+};
+
+struct EntryHash {
+    size_t operator()(int key) const {
+        return std::hash<int>()(key);
+    }
+    size_t operator()(const Entry& e) const {
+        return (*this)(e.key);
+    }
+};
+
+struct EntryEqual {
+    bool operator()(const Entry& e, int key) const {
+        return e.key == key;
+    }
+    bool operator()(const Entry& a, const Entry& b) const {
+        return a.key == b.key;
+    }
+};
+
+TEST_CASE("IntrusiveHashSet basic operations", "[IntrusiveHashSet]") {
+    IntrusiveHashSet<Entry, EntryHash, EntryEqual, HashTag> set;
+    REQUIRE(set.IsEmpty());
+    REQUIRE(set.Find(1) == nullptr);
+
+    Entry e1(1), e2(2), dup(1);
+    REQUIRE(set.Insert(&e1));
+    REQUIRE(set.Insert(&e2));
+    REQUIRE(!set.Insert(&dup));
+    REQUIRE(!dup.IsLinked());
+    REQUIRE(set.Size() == 2);
+
+    REQUIRE(set.Find(1) == &e1);
+    REQUIRE(set.Find(2) == &e2);
+    REQUIRE(set.Find(3) == nullptr);
+
+    set.Erase(&e1);
+    REQUIRE(!e1.IsLinked());
+    REQUIRE(set.Find(1) == nullptr);
+    REQUIRE(set.Size() == 1);
+
+    set.Clear();
+    REQUIRE(set.IsEmpty());
+    REQUIRE(!e2.IsLinked());
+}
+
+TEST_CASE("IntrusiveHashSet rehashes incrementally", "[IntrusiveHashSet]") {
+    const int count = 10000;
+    std::vector<std::unique_ptr<Entry>> entries;
+    IntrusiveHashSet<Entry, EntryHash, EntryEqual, HashTag> set;
+
+    bool saw_rehash = false;
+    for (int i = 0; i < count; ++i) {
+        entries.push_back(std::make_unique<Entry>(i));
+        REQUIRE(set.Insert(entries.back().get()));
+        if (set.IsRehashing()) {
+            saw_rehash = true;
+            // во время переноса видны элементы из обеих таблиц
+            REQUIRE(set.Find(i / 2) == entries[i / 2].get());
+        }
+    }
+    REQUIRE(saw_rehash);
+    REQUIRE(set.Size() == static_cast<size_t>(count));
+    REQUIRE(set.BucketCount() >= static_cast<size_t>(count));
+
+    for (int i = 0; i < count; ++i) {
+        REQUIRE(set.Find(i) == entries[i].get());
+    }
+
+    for (int i = 0; i < count; i += 2) {
+        set.Erase(entries[i].get());
+    }
+    REQUIRE(set.Size() == static_cast<size_t>(count / 2));
+
+    size_t visited = 0;
+    set.ForEach([&](Entry& e) {
+        REQUIRE(e.key % 2 == 1);
+        ++visited;
+    });
+    REQUIRE(visited == set.Size());
+    set.Clear();
+}
+
+struct CachedObject : public IntrusiveLruHook {
+    CachedObject(std::string key, int value) : key(std::move(key)), value(value) {
+    }
+
+    std::string key;
+    int value;
+};
+
+struct CachedObjectHash {
+    size_t operator()(const std::string& key) const {
+        return std::hash<std::string>()(key);
+    }
+    size_t operator()(const CachedObject& obj) const {
+        return (*this)(obj.key);
+    }
+};
+
+struct CachedObjectEqual {
+    bool operator()(const CachedObject& obj, const std::string& key) const {
+        return obj.key == key;
+    }
+    bool operator()(const CachedObject& a, const CachedObject& b) const {
+        return a.key == b.key;
+    }
+};
+
+TEST_CASE("IntrusiveLru evicts the oldest object", "[IntrusiveLru]") {
+    CachedObject a("a", 1), b("b", 2), c("c", 3), d("d", 4), dup("a", 5);
+    IntrusiveLru<CachedObject, CachedObjectHash, CachedObjectEqual> lru(3);
+
+    REQUIRE(lru.Insert(&a) == nullptr);
+    REQUIRE(lru.Insert(&b) == nullptr);
+    REQUIRE(lru.Insert(&c) == nullptr);
+    REQUIRE(lru.Insert(&dup) == &dup);
+    REQUIRE(lru.Size() == 3);
+
+    REQUIRE(lru.Get(std::string("a")) == &a);  // теперь самый старый — b
+    REQUIRE(lru.Insert(&d) == &b);
+    REQUIRE(lru.Peek(std::string("b")) == nullptr);
+    REQUIRE(lru.Peek(std::string("d"))->value == 4);
+
+    REQUIRE(lru.PopOldest() == &c);
+    lru.Erase(&a);
+    REQUIRE(lru.Size() == 1);
+    REQUIRE(lru.PopOldest() == &d);
+    REQUIRE(lru.PopOldest() == nullptr);
+    REQUIRE(lru.IsEmpty());
+}
+
+TEST_CASE("IntrusiveLru does not grow its index", "[IntrusiveLru]") {
+    const int capacity = 128;  // ровно степень двойки: лишний элемент переполнил бы корзины
+    std::vector<std::unique_ptr<CachedObject>> objects;
+    for (int i = 0; i < 10 * capacity; ++i) {
+        objects.push_back(std::make_unique<CachedObject>(std::to_string(i), i));
+    }
+
+    IntrusiveLru<CachedObject, CachedObjectHash, CachedObjectEqual> lru(capacity);
+    const size_t buckets = lru.BucketCount();
+    for (int i = 0; i < capacity; ++i) {
+        REQUIRE(lru.Insert(objects[i].get()) == nullptr);
+    }
+    REQUIRE(lru.BucketCount() == buckets);
+
+    // вставка с вытеснением, попадание и повторный ключ только перелинковывают хуки
+    const std::string hot = "0";
+    CachedObject dup(hot, -1);
+    int evicted = 0;
+    int mismatches = 0;
+    EXPECT_ZERO_ALLOCATIONS({
+        for (int i = capacity; i < 10 * capacity; ++i) {
+            mismatches += lru.Get(hot) != objects[0].get();
+            mismatches += lru.Insert(&dup) != &dup;
+            CachedObject* out = lru.Insert(objects[i].get());
+            mismatches += out == nullptr || out->value != evicted + 1;  // "0" всё время свежий
+            ++evicted;
+        }
+    });
+    REQUIRE(mismatches == 0);
+    REQUIRE(lru.BucketCount() == buckets);
+    REQUIRE(lru.Size() == static_cast<size_t>(capacity));
+    REQUIRE(evicted == 9 * capacity);
+    lru.Clear();
+}
@@ -0,0 +1,217 @@
+// Бенчмарк Deque против std::deque и непрерывного кольцевого буфера.
+// Запуск: bench_deque [max_size] > result.json
+// Размеры идут от 1K до max_size (по умолчанию 100M) с шагом x10.
+// Результат — JSON на stdout, прогресс — в stderr.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+#include "bench.h"
+#include "deque.h"
+
+namespace {
+
+// Кольцевой буфер в одном непрерывном массиве, ёмкость — степень двойки
+class RingBuffer {
+public:
+    RingBuffer() = default;
+
+    RingBuffer(const RingBuffer& other)
+        : data_(other.data_), head_(other.head_), size_(other.size_) {
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    void PushBack(int value) {
+        GrowIfFull();
+        data_[(head_ + size_) & Mask()] = value;
+        ++size_;
+    }
+
+    void PushFront(int value) {
+        GrowIfFull();
+        head_ = (head_ - 1) & Mask();
+        data_[head_] = value;
+        ++size_;
+    }
+
+    void PopFront() {
+        head_ = (head_ + 1) & Mask();
+        --size_;
+    }
+
+    int& operator[](size_t i) {
+        return data_[(head_ + i) & Mask()];
+    }
+
+private:
+    std::vector<int> data_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+
+    size_t Mask() const {
+        return data_.size() - 1;
+    }
+
+    void GrowIfFull() {
+        if (size_ < data_.size()) {
+            return;
+        }
+        std::vector<int> grown(std::max<size_t>(16, data_.size() * 2));
+        for (size_t i = 0; i < size_; ++i) {
+            grown[i] = (*this)[i];
+        }
+        data_.swap(grown);
+        head_ = 0;
+    }
+};
+
+// Единый интерфейс для трёх реализаций
+void PushBack(Deque& c, int v) {
+    c.PushBack(v);
+}
+void PushBack(std::deque<int>& c, int v) {
+    c.push_back(v);
+}
+void PushBack(RingBuffer& c, int v) {
+    c.PushBack(v);
+}
+
+void PushFront(Deque& c, int v) {
+    c.PushFront(v);
+}
+void PushFront(std::deque<int>& c, int v) {
+    c.push_front(v);
+}
+void PushFront(RingBuffer& c, int v) {
+    c.PushFront(v);
+}
+
+void PopFront(Deque& c) {
+    c.PopFront();
+}
+void PopFront(std::deque<int>& c) {
+    c.pop_front();
+}
+void PopFront(RingBuffer& c) {
+    c.PopFront();
+}
+
+size_t SizeOf(const Deque& c) {
+    return c.Size();
+}
+size_t SizeOf(const std::deque<int>& c) {
+    return c.size();
+}
+size_t SizeOf(const RingBuffer& c) {
+    return c.Size();
+}
+
+uint64_t NextRandom(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+template <class C>
+C Filled(size_t n) {
+    C c;
+    for (size_t i = 0; i < n; ++i) {
+        PushBack(c, static_cast<int>(i));
+    }
+    return c;
+}
+
+template <class C>
+void RunAll(const char* impl, size_t n, bench::Report* report) {
+    // маленькие размеры повторяем, чтобы каждое измерение было ~10M операций
+    const int reps = static_cast<int>(std::max<size_t>(1, 10'000'000 / n));
+    auto add = [&](const char* op, double ns) {
+        report->Add().Set("op", op).Set("impl", impl).Set("size", n).Set("ns_per_op", ns);
+        std::fprintf(stderr, "%-14s %-10s %10zu %8.2f ns/op\n", op, impl, n, ns);
+    };
+
+    add("push_back", bench::BestNsPerOp(n, [&] {
+            C c;
+            for (size_t i = 0; i < n; ++i) {
+                PushBack(c, static_cast<int>(i));
+            }
+            bench::Consume(SizeOf(c));
+        }, reps));
+
+    add("push_front", bench::BestNsPerOp(n, [&] {
+            C c;
+            for (size_t i = 0; i < n; ++i) {
+                PushFront(c, static_cast<int>(i));
+            }
+            bench::Consume(SizeOf(c));
+        }, reps));
+
+    {
+        // заполнение не входит в замер, поэтому один прогон
+        C c = Filled<C>(n);
+        add("pop_front", bench::BestNsPerOp(n, [&] {
+                for (size_t i = 0; i < n; ++i) {
+                    PopFront(c);
+                }
+                bench::Consume(SizeOf(c));
+            }, 1));
+    }
+
+    C c = Filled<C>(n);
+
+    add("random_access", bench::BestNsPerOp(n, [&] {
+            uint64_t state = 88172645463325252ull;
+            int64_t sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                sum += c[NextRandom(state) % n];
+            }
+            bench::Consume(sum);
+        }, reps));
+
+    add("sequential", bench::BestNsPerOp(n, [&] {
+            int64_t sum = 0;
+            for (size_t i = 0; i < n; ++i) {
+                sum += c[i];
+            }
+            bench::Consume(sum);
+        }, reps));
+
+    add("copy", bench::BestNsPerOp(n, [&] {
+            C copy(c);
+            bench::Consume(SizeOf(copy));
+        }, reps));
+
+    add("fifo", bench::BestNsPerOp(n, [&] {
+            for (size_t i = 0; i < n; ++i) {
+                PushBack(c, static_cast<int>(i));
+                PopFront(c);
+            }
+            bench::Consume(SizeOf(c));
+        }, reps));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    size_t max_size = 100'000'000;
+    if (argc > 1) {
+        max_size = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    bench::Report report("deque");
+    for (size_t n = 1000; n <= max_size; n *= 10) {
+        RunAll<Deque>("Deque", n, &report);
+        RunAll<std::deque<int>>("std::deque", n, &report);
+        RunAll<RingBuffer>("RingBuffer", n, &report);
+    }
+    report.Print();
+    return 0;
+}
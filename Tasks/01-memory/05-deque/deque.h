@@ -5,6 +5,63 @@
 #include <algorithm>
 #include <stdexcept>
 #include <cstring>
+#include <atomic>
+#include <mutex>
+
+// Сколько памяти держит дек (в байтах)
+struct DequeMemoryUsage {
+    size_t element_bytes = 0;  // полезные данные: Size() * sizeof(int)
+    size_t block_bytes = 0;    // все выделенные блоки целиком
+    size_t ring_bytes = 0;     // кольцевой буфер указателей на блоки
+    size_t slack_bytes = 0;    // пустые ячейки в блоках + пустые слоты кольца
+
+    size_t Total() const {
+        return block_bytes + ring_bytes;
+    }
+
+    DequeMemoryUsage& operator+=(const DequeMemoryUsage& other) {
+        element_bytes += other.element_bytes;
+        block_bytes += other.block_bytes;
+        ring_bytes += other.ring_bytes;
+        slack_bytes += other.slack_bytes;
+        return *this;
+    }
+};
+
+class Deque;
+
+// Глобальный реестр живых деков. По умолчанию выключен: пока не вызван Enable(),
+// конструкторы Deque только читают один atomic-флаг.
+// Деки, созданные до Enable(), не учитываются; после Disable() уже
+// зарегистрированные остаются в реестре до своего уничтожения.
+// TotalUsage() читает деки без синхронизации с их владельцами — вызывать,
+// когда учитываемые деки не модифицируются конкурентно.
+class DequeRegistry {
+public:
+    static void Enable() {
+        enabled_.store(true, std::memory_order_relaxed);
+    }
+    static void Disable() {
+        enabled_.store(false, std::memory_order_relaxed);
+    }
+    static bool IsEnabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    static size_t Count();
+    static DequeMemoryUsage TotalUsage();
+
+private:
+    friend class Deque;
+
+    static void Register(Deque* deque);
+    static void Unregister(Deque* deque);
+
+    static inline std::atomic<bool> enabled_{false};
+    static inline std::mutex mutex_;
+    static inline Deque* head_ = nullptr;  // интрузивный двусвязный список
+    static inline size_t count_ = 0;
+};
 
 class Deque {
 public:
@@ -18,7 +75,9 @@ public:
           size_buf_(0),
           size_(0),
           start_block_(0),
-          start_offset_(0) {}
+          start_offset_(0) {
+        TrackIfEnabled();
+    }
 
     // Count ctor (fill zeros)
     explicit Deque(size_t n)
@@ -28,26 +87,28 @@ public:
           size_(0),
           start_block_(0),
           start_offset_(0) {
-        if (n == 0) {
-            return;
-        }
-        // сколько блоков нужно
-        size_t needed_blocks = (n + BLOCK_SIZE - 1) / BLOCK_SIZE;
-        // вместимость буфера — двойной запас
-        capacity_buf_ = std::max<size_t>(1, needed_blocks * 2);
-        blocks_ = new int*[capacity_buf_];
-        for (size_t i = 0; i < capacity_buf_; ++i) {
-            blocks_[i] = nullptr;
-        }
+        if (n != 0) {
+            // сколько блоков нужно
+            size_t needed_blocks = (n + BLOCK_SIZE - 1) / BLOCK_SIZE;
+            // вместимость буфера — двойной запас
+            capacity_buf_ = std::max<size_t>(1, needed_blocks * 2);
+            blocks_ = new int*[capacity_buf_];
+            for (size_t i = 0; i < capacity_buf_; ++i) {
+                blocks_[i] = nullptr;
+            }
 
-        // выделяем необходимые блоки и заполняем нулями
-        for (size_t i = 0; i < needed_blocks; ++i) {
-            blocks_[i] = new int[BLOCK_SIZE](0);
+            // выделяем необходимые блоки и заполняем нулями
+            for (size_t i = 0; i < needed_blocks; ++i) {
+                blocks_[i] = new int[BLOCK_SIZE](0);
+            }
+            size_buf_ = needed_blocks;
+            size_ = n;
+            start_block_ = 0;
+            start_offset_ = 0;
         }
-        size_buf_ = needed_blocks;
-        size_ = n;
-        start_block_ = 0;
-        start_offset_ = 0;
+        // Регистрируемся последним действием: если new выше бросит, деструктор
+        // не вызовется, и в реестре не должен остаться указатель на нас
+        TrackIfEnabled();
     }
 
     // initializer_list ctor
@@ -69,6 +130,7 @@ public:
           start_block_(0),
           start_offset_(0) {
         if (other.size_ == 0) {
+            TrackIfEnabled();
             return;
         }
 
@@ -91,6 +153,8 @@ public:
         size_ = other.size_;
         start_block_ = 0;
         start_offset_ = other.start_offset_;
+        // как и в Deque(n) — только после всех выделений
+        TrackIfEnabled();
     }
 
     // Move ctor
@@ -107,6 +171,7 @@ public:
         other.size_ = 0;
         other.start_block_ = 0;
         other.start_offset_ = 0;
+        TrackIfEnabled();
     }
 
     // Copy assignment
@@ -144,6 +209,9 @@ public:
     }
 
     ~Deque() {
+        if (registered_) {
+            DequeRegistry::Unregister(this);
+        }
         Clear();            // удаляем все блоки
         delete[] blocks_;   // удаляем массив указателей
         blocks_ = nullptr;
@@ -175,6 +243,42 @@ public:
 
     size_t Size() const { return size_; }
 
+    // Разбивка занятой памяти: блоки, кольцо указателей и их незанятая часть
+    DequeMemoryUsage MemoryUsage() const {
+        DequeMemoryUsage usage;
+        usage.element_bytes = size_ * sizeof(int);
+        usage.block_bytes = size_buf_ * BLOCK_SIZE * sizeof(int);
+        usage.ring_bytes = capacity_buf_ * sizeof(int*);
+        usage.slack_bytes = (usage.block_bytes - usage.element_bytes) +
+                            (capacity_buf_ - size_buf_) * sizeof(int*);
+        return usage;
+    }
+
+    // Ужимает кольцевой буфер указателей до числа выделенных блоков.
+    // Сами блоки не двигаются, так что ссылки на элементы остаются валидными.
+    void ShrinkToFit() {
+        if (size_buf_ == capacity_buf_) {
+            return;
+        }
+        if (size_buf_ == 0) {
+            delete[] blocks_;
+            blocks_ = nullptr;
+            capacity_buf_ = 0;
+            start_block_ = 0;
+            return;
+        }
+
+        int** new_blocks = new int*[size_buf_];
+        for (size_t i = 0; i < size_buf_; ++i) {
+            new_blocks[i] = blocks_[(start_block_ + i) % capacity_buf_];
+        }
+        delete[] blocks_;
+
+        blocks_ = new_blocks;
+        capacity_buf_ = size_buf_;
+        start_block_ = 0;
+    }
+
     void Clear() {
         if (blocks_ != nullptr && capacity_buf_ > 0 && size_buf_ > 0) {
             // удаляем только реально выделенные блоки (size_buf_ штук, начиная с start_block_)
@@ -368,6 +472,18 @@ private:
     size_t start_block_ = 0;     // индекс блока с первым элементом (в blocks_)
     size_t start_offset_ = 0;    // смещение первого элемента в start_block_
 
+    // Звено списка DequeRegistry (не участвует в Swap и перемещении)
+    friend class DequeRegistry;
+    bool registered_ = false;
+    Deque* registry_prev_ = nullptr;
+    Deque* registry_next_ = nullptr;
+
+    void TrackIfEnabled() {
+        if (DequeRegistry::IsEnabled()) {
+            DequeRegistry::Register(this);
+        }
+    }
+
     // Увеличить capacity буфера указателей до >= min_blocks (стратегия ×2)
     void EnsureCapacityBlocks(size_t min_blocks) {
         if (capacity_buf_ >= min_blocks) {
@@ -405,3 +521,45 @@ private:
         // size_buf_ остаётся прежним
     }
 };
+
+inline size_t DequeRegistry::Count() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_;
+}
+
+inline DequeMemoryUsage DequeRegistry::TotalUsage() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    DequeMemoryUsage total;
+    for (const Deque* it = head_; it != nullptr; it = it->registry_next_) {
+        total += it->MemoryUsage();
+    }
+    return total;
+}
+
+inline void DequeRegistry::Register(Deque* deque) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    deque->registry_prev_ = nullptr;
+    deque->registry_next_ = head_;
+    if (head_ != nullptr) {
+        head_->registry_prev_ = deque;
+    }
+    head_ = deque;
+    deque->registered_ = true;
+    ++count_;
+}
+
+inline void DequeRegistry::Unregister(Deque* deque) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (deque->registry_prev_ != nullptr) {
+        deque->registry_prev_->registry_next_ = deque->registry_next_;
+    } else {
+        head_ = deque->registry_next_;
+    }
+    if (deque->registry_next_ != nullptr) {
+        deque->registry_next_->registry_prev_ = deque->registry_prev_;
+    }
+    deque->registry_prev_ = nullptr;
+    deque->registry_next_ = nullptr;
+    deque->registered_ = false;
+    --count_;
+}
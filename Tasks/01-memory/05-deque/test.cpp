@@ -251,3 +251,68 @@ TEST_CASE("Front and back traversing the same block") {
     }
     REQUIRE(a.Size() == 0u);
 }
+
+TEST_CASE("Memory usage") {
+    Deque a;
+    REQUIRE(a.MemoryUsage().Total() == 0u);
+
+    const int iterations = 1e4;
+    for (int i = 0; i < iterations; ++i) {
+        a.PushBack(i);
+    }
+    auto usage = a.MemoryUsage();
+    REQUIRE(usage.element_bytes == iterations * sizeof(int));
+    REQUIRE(usage.block_bytes >= usage.element_bytes);
+    REQUIRE(usage.block_bytes - usage.element_bytes < 128 * sizeof(int));
+    REQUIRE(usage.Total() == usage.block_bytes + usage.ring_bytes);
+
+    // после всплеска кольцо указателей остаётся большим
+    int* first = &a[0];
+    for (int i = 0; i < iterations - 1; ++i) {
+        a.PopBack();
+    }
+    auto bloated = a.MemoryUsage();
+    REQUIRE(bloated.block_bytes == 128 * sizeof(int));
+    REQUIRE(bloated.ring_bytes > sizeof(int*));
+
+    a.ShrinkToFit();
+    auto shrunk = a.MemoryUsage();
+    REQUIRE(shrunk.ring_bytes == sizeof(int*));
+    REQUIRE(shrunk.slack_bytes == 127 * sizeof(int));
+    REQUIRE(&a[0] == first);
+    REQUIRE(a[0] == 0);
+
+    a.PushFront(-1);
+    a.PushBack(1);
+    Check(a, std::vector<int>{-1, 0, 1});
+
+    a.Clear();
+    a.ShrinkToFit();
+    REQUIRE(a.MemoryUsage().Total() == 0u);
+    a.PushBack(5);
+    Check(a, std::vector<int>{5});
+}
+
+TEST_CASE("Memory registry") {
+    REQUIRE(!DequeRegistry::IsEnabled());
+    Deque untracked{1, 2, 3};
+    REQUIRE(DequeRegistry::Count() == 0u);
+
+    DequeRegistry::Enable();
+    {
+        Deque a{1, 2, 3};
+        Deque b(1000);
+        Deque c(std::move(b));
+        REQUIRE(DequeRegistry::Count() == 3u);
+
+        auto total = DequeRegistry::TotalUsage();
+        auto expected = a.MemoryUsage();
+        expected += b.MemoryUsage();
+        expected += c.MemoryUsage();
+        REQUIRE(total.element_bytes == 1003 * sizeof(int));
+        REQUIRE(total.Total() == expected.Total());
+        REQUIRE(total.slack_bytes == expected.slack_bytes);
+    }
+    REQUIRE(DequeRegistry::Count() == 0u);
+    DequeRegistry::Disable();
+}
@@ -0,0 +1,60 @@
+// Цена копирования и записи в COWVector.
+// Запуск: bench_cow_vector > result.json
+// Файл собирается дважды: bench_cow_vector с атомарным счётчиком и
+// bench_cow_vector_st с -DCOW_VECTOR_SINGLE_THREADED; impl в выводе их различает.
+//   copy       — копия вектора и её уничтожение (инкремент и декремент);
+//   set_unique — Set в неразделённый вектор (узлы меняются на месте);
+//   set_shared — копия, Set в неё (копия пути до листа) и уничтожение.
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "cow_vector.h"
+
+namespace {
+
+#ifdef COW_VECTOR_SINGLE_THREADED
+constexpr const char* kImpl = "single_threaded";
+#else
+constexpr const char* kImpl = "atomic";
+#endif
+
+}  // namespace
+
+int main() {
+    bench::Report report("cow_vector");
+    for (size_t size : {size_t{16}, size_t{1024}, size_t{1} << 20}) {
+        COWVector vector;
+        vector.Resize(size);
+        const std::string value = "value";
+        auto add = [&](const char* op, double ns) {
+            report.Add().Set("op", op).Set("impl", kImpl).Set("size", size).Set("ns_per_op", ns);
+            std::fprintf(stderr, "%-16s %-10s %6zu %10.2f ns/op\n", kImpl, op, size, ns);
+        };
+
+        const size_t ops = size_t{1} << 22;
+        add("copy", bench::BestNsPerOp(ops, [&] {
+                for (size_t i = 0; i < ops; ++i) {
+                    COWVector copy = vector;
+                    bench::Consume(copy.Size());
+                }
+            }));
+        add("set_unique", bench::BestNsPerOp(ops, [&] {
+                for (size_t i = 0; i < ops; ++i) {
+                    vector.Set(i % size, value);
+                }
+            }));
+        add("set_shared", bench::BestNsPerOp(ops / 4, [&] {
+                for (size_t i = 0; i < ops / 4; ++i) {
+                    COWVector copy = vector;
+                    copy.Set(i % size, value);
+                    bench::Consume(copy.Size());
+                }
+            }));
+    }
+
+    report.Print();
+    return 0;
+}
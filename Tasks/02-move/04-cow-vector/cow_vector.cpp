@@ -1,30 +1,128 @@
 #include "cow_vector.h"
+#include <algorithm>
 #include <cstddef>
+#include <iterator>
+#include <stdexcept>
 #include <utility>
 
+namespace {
+
+void ReleaseNode(Node* node, size_t shift) {
+    if (!node || !node->ref_count.Decrement()) {
+        return;
+    }
+    if (shift == 0) {
+        delete static_cast<Leaf*>(node);
+        return;
+    }
+    auto* branch = static_cast<Branch*>(node);
+    for (Node* child : branch->children) {
+        ReleaseNode(child, shift - kNodeBits);
+    }
+    delete branch;
+}
+
+Node* NewNode(size_t shift) {
+    if (shift == 0) {
+        return new Leaf();
+    }
+    return new Branch();
+}
+
+// Копия узла делит с оригиналом всех детей
+Node* CopyNode(const Node* node, size_t shift) {
+    if (shift == 0) {
+        const auto* leaf = static_cast<const Leaf*>(node);
+        auto* copy = new Leaf();
+        std::copy(std::begin(leaf->values), std::end(leaf->values), copy->values);
+        return copy;
+    }
+    const auto* branch = static_cast<const Branch*>(node);
+    auto* copy = new Branch();
+    for (size_t i = 0; i < kNodeWidth; ++i) {
+        if (Node* child = branch->children[i]) {
+            child->ref_count.Increment();
+            copy->children[i] = child;
+        }
+    }
+    return copy;
+}
+
+// Делает узел в slot принадлежащим только нам: создаёт, если его нет,
+// и копирует, если он разделён
+Node* OwnNode(Node*& slot, size_t shift) {
+    if (!slot) {
+        slot = NewNode(shift);
+    } else if (!slot->ref_count.IsUnique()) {
+        Node* copy = CopyNode(slot, shift);
+        ReleaseNode(slot, shift);
+        slot = copy;
+    }
+    return slot;
+}
+
+// Оставляет в поддереве только первые size элементов. Копируются лишь узлы на
+// границе, поддеревья правее неё просто отпускаются
+void Truncate(Node*& slot, size_t shift, size_t size) {
+    if (size == 0) {
+        ReleaseNode(slot, shift);
+        slot = nullptr;
+        return;
+    }
+    if (!slot) {
+        return;
+    }
+    Node* node = OwnNode(slot, shift);
+    if (shift == 0) {
+        // чтобы при росте здесь снова оказались пустые строки
+        auto* leaf = static_cast<Leaf*>(node);
+        std::fill(leaf->values + size, std::end(leaf->values), std::string());
+        return;
+    }
+    auto* branch = static_cast<Branch*>(node);
+    const size_t span = size_t{1} << shift;
+    for (size_t i = 0; i < kNodeWidth; ++i) {
+        size_t begin = i * span;
+        if (begin >= size) {
+            ReleaseNode(branch->children[i], shift - kNodeBits);
+            branch->children[i] = nullptr;
+        } else if (size < begin + span) {
+            Truncate(branch->children[i], shift - kNodeBits, size - begin);
+        }
+    }
+}
+
+}  // namespace
+
+State::State(const State& other) : root(other.root), size(other.size), shift(other.shift) {
+    if (root) {
+        root->ref_count.Increment();
+    }
+}
+
+State::~State() {
+    ReleaseNode(root, shift);
+}
+
 // Your code goes here
 COWVector::COWVector() {
     state_ = new State();
 }
 
 COWVector::~COWVector() {
-    if (--state_->ref_count == 0) {
-        delete state_;
-    }
+    Release();
 }
 
 COWVector::COWVector(const COWVector& other) {
     state_ = other.state_;
-    state_->ref_count += 1;
+    state_->ref_count.Increment();
 }
 
 COWVector& COWVector::operator=(const COWVector& other) {
     if (this != &other) {
-        if (--state_->ref_count == 0) {
-            delete state_;
-        }
+        other.state_->ref_count.Increment();
+        Release();
         state_ = other.state_;
-        state_->ref_count += 1;
     }
     return *this;
 }
@@ -34,44 +132,112 @@ COWVector::COWVector(COWVector&& other) noexcept {
 }
 
 COWVector& COWVector::operator=(COWVector&& other) noexcept {
-    if (state_) {
-        delete state_;
+    if (this != &other) {
+        Release();
+        state_ = std::exchange(other.state_, nullptr);
     }
-    state_ = std::exchange(other.state_, nullptr);
     return *this;
 }
 
 size_t COWVector::Size() const {
-    return this->state_->vec.size();
+    return this->state_->size;
 }
 
 void COWVector::Resize(size_t size) {
     Unlink();
-    this->state_->vec.resize(size);
+    State& state = *state_;
+    if (size == 0) {
+        ReleaseNode(state.root, state.shift);
+        state.root = nullptr;
+        state.shift = 0;
+    } else if (size < state.size) {
+        Truncate(state.root, state.shift, size);
+        // снимаем верхние уровни, ставшие лишними
+        while (state.shift > 0 && size <= (kNodeWidth << (state.shift - kNodeBits))) {
+            Node* child = static_cast<Branch*>(state.root)->children[0];
+            child->ref_count.Increment();
+            ReleaseNode(state.root, state.shift);
+            state.root = child;
+            state.shift -= kNodeBits;
+        }
+    } else {
+        while (size > (kNodeWidth << state.shift)) {
+            auto* branch = new Branch();
+            branch->children[0] = state.root;
+            state.root = branch;
+            state.shift += kNodeBits;
+        }
+        // новые элементы — пустые строки: в свежих листьях они такими созданы,
+        // в хвосте старого листа их оставил Truncate
+        for (size_t at = state.size; at < size; at = (at | kNodeMask) + 1) {
+            MutableLeaf(at);
+        }
+    }
+    state.size = size;
 }
 
 const std::string& COWVector::Get(size_t at) {
-    return this->state_->vec.at(at);
+    if (at >= state_->size) {
+        throw std::out_of_range("COWVector::Get");
+    }
+    const Node* node = state_->root;
+    for (size_t shift = state_->shift; shift > 0; shift -= kNodeBits) {
+        node = static_cast<const Branch*>(node)->children[(at >> shift) & kNodeMask];
+    }
+    return static_cast<const Leaf*>(node)->values[at & kNodeMask];
 }
 
 const std::string& COWVector::Back() {
-    return this->state_->vec.back();
+    return Get(state_->size - 1);
 }
 
 void COWVector::PushBack(const std::string& value) {
     Unlink();
-    this->state_->vec.push_back(value);
+    size_t at = state_->size;
+    if (at == (kNodeWidth << state_->shift)) {
+        auto* branch = new Branch();
+        branch->children[0] = state_->root;
+        state_->root = branch;
+        state_->shift += kNodeBits;
+    }
+    MutableLeaf(at)->values[at & kNodeMask] = value;
+    ++state_->size;
 }
 
 void COWVector::Set(size_t at, const std::string& value) {
+    if (at >= state_->size) {
+        throw std::out_of_range("COWVector::Set");
+    }
     Unlink();
-    this->state_->vec[at] = value;
+    MutableLeaf(at)->values[at & kNodeMask] = value;
 }
 
 void COWVector::Unlink() {
-    if (state_->ref_count > 1) {
-        state_->ref_count--;
-        state_ = new State(*state_);
-        state_->ref_count = 1;
+    // Единственный владелец — самый частый случай при записи: один load, без RMW.
+    // Иначе новый State делит с прежним всё дерево, копирование узлов — уже
+    // в MutableLeaf и только на пути к изменяемому листу
+    if (state_->ref_count.IsUnique()) {
+        return;
+    }
+    State* copy = new State(*state_);
+    Release();
+    state_ = copy;
+}
+
+void COWVector::Release() {
+    if (state_ && state_->ref_count.Decrement()) {
+        delete state_;
+    }
+    state_ = nullptr;
+}
+
+Leaf* COWVector::MutableLeaf(size_t at) {
+    Node** slot = &state_->root;
+    for (size_t shift = state_->shift;; shift -= kNodeBits) {
+        Node* node = OwnNode(*slot, shift);
+        if (shift == 0) {
+            return static_cast<Leaf*>(node);
+        }
+        slot = &static_cast<Branch*>(node)->children[(at >> shift) & kNodeMask];
     }
 }
@@ -1,18 +1,95 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <string>
-#include <vector>
 
-struct State {
-    size_t ref_count;
-    std::vector<std::string> vec;
+// Счётчик ссылок на State. Атомарный, чтобы копии одного вектора можно было
+// отдавать в другие потоки и уничтожать там без общего лока. Сам же объект
+// COWVector из нескольких потоков одновременно менять нельзя.
+// С COW_VECTOR_SINGLE_THREADED счётчик обычный — для сравнения в бенчмарке.
+class RefCount {
+public:
+    RefCount() = default;
+    RefCount(const RefCount&) = delete;
+    RefCount& operator=(const RefCount&) = delete;
+
+#ifdef COW_VECTOR_SINGLE_THREADED
+    void Increment() {
+        ++count_;
+    }
+
+    bool Decrement() {
+        return --count_ == 0;
+    }
+
+    bool IsUnique() const {
+        return count_ == 1;
+    }
+
+private:
+    size_t count_ = 1;
+#else
+    // Новая ссылка берётся от уже существующей, так что упорядочивать нечего
+    void Increment() {
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
 
-    State() : ref_count(1) {
+    // true, если ссылка была последней. release публикует наши обращения к State
+    // тому, кто будет его удалять, acquire — забирает чужие перед delete.
+    // Вместо release + fence(acquire) — acq_rel: на x86 это та же lock xadd,
+    // а отдельные fence ThreadSanitizer не понимает
+    bool Decrement() {
+        return count_.fetch_sub(1, std::memory_order_acq_rel) == 1;
     }
 
-    State(const State& other) : ref_count(1), vec(other.vec) {
+    // acquire: если остальные владельцы уже ушли, их чтения State
+    // завершились до того, как мы начнём его менять
+    bool IsUnique() const {
+        return count_.load(std::memory_order_acquire) == 1;
     }
+
+private:
+    std::atomic<size_t> count_ = 1;
+#endif
+};
+
+// Элементы хранятся в префиксном дереве с 32 ветвями: у внутренних узлов —
+// дети, у листьев — по 32 значения, i-й элемент ищется по группам из 5 бит
+// индекса, от старших к младшим. Копии вектора делят узлы, а запись копирует
+// только те узлы на пути к своему листу, которые ещё с кем-то разделены:
+// O(log n) вместо копии всего вектора. Неразделённые узлы меняются на месте.
+inline constexpr size_t kNodeBits = 5;
+inline constexpr size_t kNodeWidth = size_t{1} << kNodeBits;
+inline constexpr size_t kNodeMask = kNodeWidth - 1;
+
+struct Node {
+    RefCount ref_count;
+};
+
+struct Branch : Node {
+    Node* children[kNodeWidth] = {};
+};
+
+struct Leaf : Node {
+    std::string values[kNodeWidth];
+};
+
+struct State {
+    RefCount ref_count;
+    Node* root = nullptr;
+    size_t size = 0;
+    // Сдвиг индекса на уровне root: 0, если root — лист, 5 — если над листьями
+    // один уровень, и так далее. В дереве помещается kNodeWidth << shift элементов
+    size_t shift = 0;
+
+    State() = default;
+
+    // Делит дерево с other, а не копирует его
+    State(const State& other);
+
+    ~State();
 };
 
 class COWVector {
@@ -44,9 +121,17 @@ public:
 
     void Set(size_t at, const std::string& value);
 
-    // Создаёт новый экземпляр вектора
+    // Отделяет State от других векторов, если он с кем-то разделён;
+    // узлы дерева при этом остаются общими
     void Unlink();
 
 private:
+    // После перемещения nullptr
     State* state_;
+
+    void Release();
+
+    // Лист с элементом at, который можно менять: недостающие узлы на пути
+    // создаются, разделённые — копируются
+    Leaf* MutableLeaf(size_t at);
 };
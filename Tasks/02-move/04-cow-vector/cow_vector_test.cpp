@@ -2,6 +2,14 @@
 
 #include <cow_vector.h>
 
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
 TEST_CASE("Simple vector operations") {
     COWVector v;
 
@@ -77,3 +85,141 @@ TEST_CASE("Correct reallocation") {
     v1.PushBack("foo");
     v1.PushBack("foo");
 }
+
+TEST_CASE("Move leaves a destructible vector") {
+    COWVector v1;
+    v1.PushBack("foo");
+    COWVector v2{v1};
+
+    COWVector v3{std::move(v1)};
+    REQUIRE(v3.Get(0) == "foo");
+
+    v3 = std::move(v2);
+    REQUIRE(v3.Get(0) == "foo");
+
+    v1 = v3;
+    REQUIRE(&v1.Get(0) == &v3.Get(0));
+}
+
+TEST_CASE("Snapshots are shared between threads") {
+    constexpr size_t kSize = 64;
+    constexpr size_t kReaders = 4;
+    constexpr int kVersions = 2000;
+
+    COWVector published;
+    published.Resize(kSize);
+    std::mutex mutex;
+
+    // Писатель меняет свою копию и публикует её; читатели берут снимок под
+    // локом, а читают и уничтожают его уже без лока
+    std::thread writer([&] {
+        COWVector own;
+        {
+            std::lock_guard lock(mutex);
+            own = published;
+        }
+        for (int version = 1; version <= kVersions; ++version) {
+            for (size_t i = 0; i < kSize; ++i) {
+                own.Set(i, std::to_string(version));
+            }
+            std::lock_guard lock(mutex);
+            published = own;
+        }
+    });
+
+    std::vector<std::thread> readers;
+    std::vector<size_t> torn(kReaders);
+    for (size_t r = 0; r < kReaders; ++r) {
+        readers.emplace_back([&, r] {
+            for (int i = 0; i < kVersions; ++i) {
+                COWVector snapshot;
+                {
+                    std::lock_guard lock(mutex);
+                    snapshot = published;
+                }
+                std::string first = snapshot.Get(0);
+                for (size_t j = 1; j < kSize; ++j) {
+                    torn[r] += snapshot.Get(j) != first;
+                }
+                COWVector copy = snapshot;
+                torn[r] += copy.Size() != kSize;
+            }
+        });
+    }
+
+    writer.join();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    for (size_t count : torn) {
+        REQUIRE(count == 0);
+    }
+    REQUIRE(published.Get(kSize - 1) == std::to_string(kVersions));
+}
+
+TEST_CASE("Writes copy only the path to the leaf") {
+    constexpr size_t kSize = 100000;
+    COWVector v1;
+    for (size_t i = 0; i < kSize; ++i) {
+        v1.PushBack(std::to_string(i));
+    }
+
+    COWVector v2{v1};
+    v2.Set(kSize / 2, "changed");
+    v2.PushBack("tail");
+
+    REQUIRE(v1.Size() == kSize);
+    REQUIRE(v2.Size() == kSize + 1);
+    REQUIRE(v1.Get(kSize / 2) == std::to_string(kSize / 2));
+    REQUIRE(v2.Get(kSize / 2) == "changed");
+    REQUIRE(v2.Back() == "tail");
+
+    // Соседи по листу скопированы, остальные элементы по-прежнему общие
+    REQUIRE(&v1.Get(kSize / 2 + 1) != &v2.Get(kSize / 2 + 1));
+    REQUIRE(&v1.Get(0) == &v2.Get(0));
+    REQUIRE(&v1.Get(kSize / 4) == &v2.Get(kSize / 4));
+
+    REQUIRE_THROWS_AS(v1.Get(kSize), std::out_of_range);
+    REQUIRE_THROWS_AS(v1.Set(kSize, "x"), std::out_of_range);
+}
+
+TEST_CASE("Versions stay independent") {
+    std::mt19937 gen(50);
+    std::vector<std::pair<COWVector, std::vector<std::string>>> versions(1);
+
+    for (int step = 0; step < 3000; ++step) {
+        auto [vector, model] = versions[gen() % versions.size()];
+        switch (gen() % 5) {
+            case 0: {
+                size_t size = gen() % 3 == 0 ? gen() % 40 : gen() % 2000;
+                vector.Resize(size);
+                model.resize(size);
+                break;
+            }
+            case 1:
+            case 2: {
+                std::string value = std::to_string(step);
+                vector.PushBack(value);
+                model.push_back(value);
+                break;
+            }
+            default:
+                if (!model.empty()) {
+                    size_t at = gen() % model.size();
+                    vector.Set(at, std::to_string(-step));
+                    model[at] = std::to_string(-step);
+                }
+        }
+        versions.emplace_back(std::move(vector), std::move(model));
+        if (versions.size() > 50) {
+            versions.erase(versions.begin() + gen() % versions.size());
+        }
+    }
+
+    for (auto& [vector, model] : versions) {
+        REQUIRE(vector.Size() == model.size());
+        for (size_t i = 0; i < model.size(); ++i) {
+            REQUIRE(vector.Get(i) == model[i]);
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+// Общее для всех бенчмарков: замер времени и вывод результатов в JSON
+//
+//     bench::Report report("deque");
+//     double ns = bench::BestNsPerOp(n, [&] { ... bench::Consume(sum); });
+//     report.Add().Set("op", "push_back").Set("size", n).Set("ns_per_op", ns);
+//     report.Print();  // на stdout; прогресс бенчмарки пишут в stderr
+//
+// Подключается из каталога задачи через
+//     target_include_directories(bench_x PRIVATE ${CMAKE_CURRENT_SOURCE_DIR}/../../bench)
+
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+// Сюда складываются результаты, чтобы компилятор не выкинул вычисления.
+// Только из одного потока: многопоточные бенчмарки копят значения по потокам
+inline volatile size_t sink = 0;
+
+template <class T>
+void Consume(T value) {
+    sink = sink + static_cast<size_t>(value);
+}
+
+// Наименьшее из repeats время одного вызова body, нс
+template <class Body>
+double BestNs(Body body, int repeats = 5) {
+    double best = 0;
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto finish = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(finish - start).count();
+        if (r == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+// body выполняет ops операций
+template <class Body>
+double BestNsPerOp(size_t ops, Body body, int repeats = 5) {
+    return BestNs(body, repeats) / static_cast<double>(ops);
+}
+
+// body обрабатывает bytes байт
+template <class Body>
+double BestGbPerS(size_t bytes, Body body, int repeats = 5) {
+    return static_cast<double>(bytes) / BestNs(body, repeats);
+}
+
+// Результаты бенчмарка в формате
+//     {"benchmark": "<name>", "results": [{"op": ..., ...}, ...]}
+// Поля у записей произвольные и печатаются в порядке добавления
+class Report {
+public:
+    class Record {
+    public:
+        Record& Set(const char* key, const std::string& value) {
+            std::string quoted = "\"";
+            for (char c : value) {
+                if (c == '"' || c == '\\') {
+                    quoted += '\\';
+                }
+                quoted += c;
+            }
+            fields_.emplace_back(key, quoted + "\"");
+            return *this;
+        }
+
+        Record& Set(const char* key, const char* value) {
+            return Set(key, std::string(value));
+        }
+
+        template <std::integral T>
+        Record& Set(const char* key, T value) {
+            fields_.emplace_back(key, std::to_string(value));
+            return *this;
+        }
+
+        template <std::floating_point T>
+        Record& Set(const char* key, T value) {
+            char buffer[64];
+            std::snprintf(buffer, sizeof(buffer), "%.3f", static_cast<double>(value));
+            fields_.emplace_back(key, buffer);
+            return *this;
+        }
+
+    private:
+        friend class Report;
+
+        std::vector<std::pair<std::string, std::string>> fields_;
+    };
+
+    explicit Report(std::string name) : name_(std::move(name)) {
+    }
+
+    // Ссылка остаётся действительной до конца жизни Report
+    Record& Add() {
+        return records_.emplace_back();
+    }
+
+    void Print() const {
+        std::printf("{\n  \"benchmark\": \"%s\",\n  \"results\": [\n", name_.c_str());
+        for (size_t i = 0; i < records_.size(); ++i) {
+            std::printf("    {");
+            const auto& fields = records_[i].fields_;
+            for (size_t j = 0; j < fields.size(); ++j) {
+                std::printf("%s\"%s\": %s", j == 0 ? "" : ", ", fields[j].first.c_str(),
+                            fields[j].second.c_str());
+            }
+            std::printf("}%s\n", i + 1 == records_.size() ? "" : ",");
+        }
+        std::printf("  ]\n}\n");
+    }
+
+private:
+    std::string name_;
+    std::deque<Record> records_;
+};
+
+}  // namespace bench